@@ -13,6 +13,7 @@
 class G4BOptnChangeCrossSection;
 class G4ParticleDefinition;
 #include <map>
+#include <vector>
 
 class ChangeCrossSection : public G4VBiasingOperator {
 public:
@@ -56,10 +57,18 @@ private:
                                  G4VBiasingOperation*                finalStateOperationApplied,
                                  const G4VParticleChange*                particleChangeProduced );
 
+private:
+  // -- Find the operation of a biased process (linear scan over the few biased processes):
+  G4BOptnChangeCrossSection* GetBiasedOperation( const G4BiasingProcessInterface* callingProcess ) const;
+
 private:
   // -- List of associations between processes and biasing operations:
   std::map< const G4BiasingProcessInterface*,
             G4BOptnChangeCrossSection*       > fChangeCrossSectionOperations;
+  // -- Processes selected by /bias/processes and their operations, refreshed at each run:
+  std::vector< const G4BiasingProcessInterface* > fBiasedProcesses;
+  std::vector< G4BOptnChangeCrossSection* >       fBiasedOperations;
+  G4double                                        fXStransformation;
   G4bool                                  fSetup;
   const G4ParticleDefinition*    fParticleToBias;
 
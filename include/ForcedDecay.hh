@@ -0,0 +1,63 @@
+
+//
+//-----------------------------------------------------------------
+//
+// Forced decay of particles inside the fiducial decay zone, in the
+// style of the G4 example GB01 operators
+//
+//-----------------------------------------------------------------
+//
+
+#ifndef ForcedDecay_hh
+#define ForcedDecay_hh 1
+
+#include "G4VBiasingOperator.hh"
+class ForcedDecayOperation;
+
+class ForcedDecay : public G4VBiasingOperator {
+public:
+  ForcedDecay(G4String name = "ForcedDecay");
+  virtual ~ForcedDecay();
+
+private:
+  // -----------------------------
+  // -- Mandatory from base class:
+  // -----------------------------
+  // -- This method returns the forced decay operation once the track is inside the zone:
+  virtual G4VBiasingOperation*
+  ProposeOccurenceBiasingOperation(const G4Track*                            track,
+                                   const G4BiasingProcessInterface* callingProcess);
+  // -- Methods not used:
+  virtual G4VBiasingOperation*
+  ProposeFinalStateBiasingOperation(const G4Track*, const G4BiasingProcessInterface*)
+  {return 0;}
+  virtual G4VBiasingOperation*
+  ProposeNonPhysicsBiasingOperation(const G4Track*, const G4BiasingProcessInterface*)
+  {return 0;}
+
+private:
+  // -- ("using" is to avoid compiler complaining against (false) method shadowing.)
+  using G4VBiasingOperator::OperationApplied;
+
+  // -- Optionnal base class method implementation.
+  // -- This method is called to inform the operator that a proposed operation has been applied.
+  // -- In the present case, it means that the forced decay occured:
+  virtual void OperationApplied( const G4BiasingProcessInterface*                callingProcess,
+                                 G4BiasingAppliedCase                               biasingCase,
+                                 G4VBiasingOperation*                 occurenceOperationApplied,
+                                 G4double                         weightForOccurenceInteraction,
+                                 G4VBiasingOperation*                finalStateOperationApplied,
+                                 const G4VParticleChange*                particleChangeProduced );
+
+public:
+  // -- Optionnal base class method. It is called at the time a tracking of a particle starts:
+  void StartTracking( const G4Track* track );
+
+private:
+  ForcedDecayOperation* fForcedDecayOperation;
+  // -- forcing state of the current track:
+  G4bool                fForcing;
+  G4bool                fDone;
+};
+
+#endif
@@ -0,0 +1,58 @@
+
+//
+//-----------------------------------------------------------------
+//
+// Occurence biasing operation forcing an interaction within a
+// given distance, following G4BOptnChangeCrossSection
+//
+//-----------------------------------------------------------------
+//
+
+#ifndef ForcedDecayOperation_hh
+#define ForcedDecayOperation_hh 1
+
+#include "G4VBiasingOperation.hh"
+class G4ILawTruncatedExp;
+
+class ForcedDecayOperation : public G4VBiasingOperation {
+public:
+  ForcedDecayOperation(G4String name);
+  virtual ~ForcedDecayOperation();
+
+  // -----------------------------------------------------
+  // -- Methods from G4VBiasingOperation interface:
+  // -----------------------------------------------------
+  // -- Used for occurence biasing: the truncated exponential law.
+  virtual const G4VBiasingInteractionLaw*
+  ProvideOccurenceBiasingInteractionLaw( const G4BiasingProcessInterface*, G4ForceCondition& );
+  // -- Methods not used:
+  virtual G4VParticleChange* ApplyFinalStateBiasing( const G4BiasingProcessInterface*,
+                                                     const G4Track*,
+                                                     const G4Step*,
+                                                     G4bool& )
+  {return 0;}
+  virtual G4double DistanceToApplyOperation( const G4Track*,
+                                             G4double,
+                                             G4ForceCondition* )
+  {return DBL_MAX;}
+  virtual G4VParticleChange* GenerateBiasingFinalState( const G4Track*,
+                                                        const G4Step* )
+  {return 0;}
+
+public:
+  // -- Additional methods, specific to this class:
+  // -- Force the interaction within maximumDistance for the analog cross-section
+  // -- and sample the interaction point:
+  void Setup( G4double analogCrossSection, G4double maximumDistance );
+  // -- Update the law for a step without interaction:
+  void UpdateForStep( G4double truePathLength );
+  // -- Interaction occurence flag:
+  void   SetInteractionOccured()       { fInteractionOccured = true; }
+  G4bool GetInteractionOccured() const { return fInteractionOccured; }
+
+private:
+  G4ILawTruncatedExp* fTruncatedExpLaw;
+  G4bool              fInteractionOccured;
+};
+
+#endif
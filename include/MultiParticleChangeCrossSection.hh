@@ -14,7 +14,8 @@
 class ChangeCrossSection;
 class G4ParticleDefinition;
 
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 class MultiParticleChangeCrossSection : public G4VBiasingOperator {
 public:
@@ -29,6 +30,9 @@ public:
   // -- in the main program.
   void AddParticle( G4String particleName );
 
+  // -- Refresh the particles selected by /bias/particles at the beginning of each run:
+  virtual void StartRun();
+
 
 private:
   // -----------------------------
@@ -67,13 +71,22 @@ public:
   void StartTracking( const G4Track* track );
 
 private:
-  // -- List of associations between particle types and biasing operators:
-  std::map < const G4ParticleDefinition*, ChangeCrossSection* >    fBOptrForParticle;
+  // -- Particle types and their biasing operators, by index; the operator of the
+  // -- current track is resolved once in StartTracking:
   std::vector < const G4ParticleDefinition* >   fParticlesToBias;
+  std::vector < ChangeCrossSection* >           fBOptrForParticle;
+  std::vector < G4bool >                        fParticleBiased;
   ChangeCrossSection*                  fCurrentOperator;
 
   // -- count number of biased interations for current track:
   G4int fnInteractions;
+
+  // -- generation of the current track and of the biased tracks of the current event:
+  G4int                                 fGeneration;
+  G4int                                 fDepth;
+  G4int                                 fInteractionLimit;
+  G4int                                 fEventID;
+  std::unordered_map < G4int, G4int >   fGenerations;
 };
 
 #endif
@@ -0,0 +1,36 @@
+/* include/MuonFastPhysicsList.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__MUON_FAST_PHYSICS_LIST_HH
+#define MU__MUON_FAST_PHYSICS_LIST_HH
+#pragma once
+
+#include <G4VModularPhysicsList.hh>
+
+namespace MATHUSLA { namespace MU {
+
+//__Muon-Optimised Lightweight Physics List_____________________________________________________
+class MuonFastPhysicsList : public G4VModularPhysicsList {
+public:
+  MuonFastPhysicsList(bool hadronic=false);
+  void SetCuts();
+};
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__MUON_FAST_PHYSICS_LIST_HH */
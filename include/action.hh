@@ -24,14 +24,19 @@
 #include <G4UserEventAction.hh>
 #include <G4UserRunAction.hh>
 #include <G4UserSteppingAction.hh>
+#include <G4UserStackingAction.hh>
 #include <G4UserTrackingAction.hh>
 #include <G4VUserPrimaryGeneratorAction.hh>
 #include <G4Event.hh>
 #include <G4Track.hh>
+#include <G4TrackVector.hh>
 #include <G4Run.hh>
 #include "TROOT.h"
 #include "TTree.h"
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "physics/Generator.hh"
 #include "ui.hh"
 
@@ -56,6 +61,8 @@ public:
   void EndOfEventAction(const G4Event* event);
   static const G4Event* GetEvent();
   static size_t EventID();
+  static double Weight();
+  static void ScaleWeight(double factor);
 };
 //----------------------------------------------------------------------------------------------
 
@@ -88,6 +95,55 @@ private:
 };
 //----------------------------------------------------------------------------------------------
 
+//__Stacking Action Manager_____________________________________________________________________
+class StackingAction : public G4UserStackingAction, public G4UImessenger {
+public:
+  StackingAction();
+  G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+  void NewStage();
+  void PrepareNewEvent();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+  static void TrackFinished(const G4Track* track, const G4TrackVector* secondaries);
+  static std::size_t KilledCount();
+  static std::size_t DeferredCount();
+  static std::size_t AbortedCount();
+  static void ResetCounters();
+
+private:
+  struct Rule {
+    double min_energy, max_distance;
+  };
+
+  G4ClassificationOfNewTrack _classify(const G4Track* track);
+  bool _reachable(const G4Track* track);
+  bool _load_envelope();
+  double _distance_to_envelope(const G4ThreeVector& position) const;
+  bool _heads_into_envelope(const G4ThreeVector& position,
+                            const G4ThreeVector& direction) const;
+
+  std::unordered_map<const G4ParticleDefinition*, Rule> _rules;
+  bool _defer;
+  bool _abort_enabled;
+  double _abort_min_energy;
+  std::unordered_set<G4int> _reachable_tracks;
+  std::string _envelope_name;
+  int _envelope_state;
+  std::size_t _envelope_geometry;
+  G4ThreeVector _envelope_min, _envelope_max;
+  std::size_t _stage;
+
+  Command::StringArg*     _rule;
+  Command::NoArg*         _clear;
+  Command::StringArg*     _mode;
+  Command::StringArg*     _envelope;
+  Command::BoolArg*       _abort;
+  Command::DoubleUnitArg* _abort_energy;
+  Command::NoArg*         _print;
+};
+//----------------------------------------------------------------------------------------------
+
 class TrackingAction : public G4UserTrackingAction{
 
   public:
@@ -97,6 +153,9 @@ class TrackingAction : public G4UserTrackingAction{
     virtual void PreUserTrackingAction(const G4Track*);
     virtual void PostUserTrackingAction(const G4Track*);
 
+  private:
+    G4double fInitialWeight;
+
 };
 
 //----------------------------------------------------------------------------------------------
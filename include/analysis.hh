@@ -208,15 +208,17 @@ static const DataKeyList DefaultDataKeyList{
   "Hit_particlePdgId", "Hit_G4TrackId", "Hit_G4ParentTrackId",
   "Hit_x", "Hit_y", "Hit_z",
   "Hit_particleEnergy", "Hit_particlePx", "Hit_particlePy", "Hit_particlePz",
-  "Hit_weight",
+  "Hit_weight", "Hit_preStepWeight",
 
   "NumGenParticles",
+  "Event_weight",
 
   "GenParticle_index", "GenParticle_G4index", "GenParticle_pdgid", "GenParticle_status",
   "GenParticle_time", "GenParticle_x", "GenParticle_y", "GenParticle_z",
   "GenParticle_energy", "GenParticle_px", "GenParticle_py", "GenParticle_pz",
   "GenParticle_mo1", "GenParticle_mo2", "GenParticle_dau1", "GenParticle_dau2",
   "GenParticle_mass", "GenParticle_pt", "GenParticle_eta", "GenParticle_phi",
+  "GenParticle_weight",
 
   "COSMIC_EVENT_ID",
 
@@ -251,7 +253,9 @@ static const DataKeyTypeList DefaultDataKeyTypeList{
   DataKeyType::Vector,
   DataKeyType::Vector,
   DataKeyType::Vector,
+  DataKeyType::Vector,
 
+  DataKeyType::Single,
   DataKeyType::Single,
 
   DataKeyType::Vector,
@@ -274,6 +278,7 @@ static const DataKeyTypeList DefaultDataKeyTypeList{
   DataKeyType::Vector,
   DataKeyType::Vector,
   DataKeyType::Vector,
+  DataKeyType::Vector,
 
   DataKeyType::Vector,
   DataKeyType::Vector,
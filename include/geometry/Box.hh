@@ -66,6 +66,43 @@ private:
   double _length, _height, _width, _thickness;
 };
 
+//__Virtual Readout Segmentation________________________________________________________________
+class Readout : public G4UImessenger {
+public:
+  enum class Orientation { X, Z };
+
+  struct Layer {
+    std::string name;
+    int id;
+    Orientation orientation;
+    double pitch, length, gap;
+  };
+
+  Readout();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+  static void Clear();
+  static void Register(const G4VPhysicalVolume* volume,
+                       const std::string& layer,
+                       const int column=0,
+                       const int row=0);
+  static bool Locate(const G4Step* step,
+                     std::string& chamber);
+  static std::ostream& Print(std::ostream& os=std::cout);
+
+private:
+  Command::StringArg*     _select;
+  Command::IntegerArg*    _id;
+  Command::StringArg*     _orientation;
+  Command::DoubleUnitArg* _pitch;
+  Command::DoubleUnitArg* _length;
+  Command::DoubleUnitArg* _gap;
+  Command::NoArg*         _print;
+};
+//----------------------------------------------------------------------------------------------
+
 class Detector : public G4VSensitiveDetector {
 public:
   Detector();
@@ -66,6 +66,7 @@ public:
   static void SaveInfo(std::string&  prefix);
 
   static const std::string& GetDetectorName();
+  static std::size_t GetGeometryVersion();
   static bool IsDetectorDataPerEvent();
   static const std::string& GetDetectorDataName();
   static const Analysis::ROOT::DataKeyList& GetDetectorDataKeys();
@@ -75,6 +76,28 @@ private:
   Command::NoArg*     _list;
   Command::NoArg*     _current;
   Command::StringArg* _select;
+  G4UImessenger*      _readout;
+  G4UImessenger*      _regions;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Production Cut and Step Limit Regions_______________________________________________________
+class Regions : public G4UImessenger {
+public:
+  Regions();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+  static void Clear();
+  static void Add(const std::string& region,
+                  G4LogicalVolume* volume);
+  static std::ostream& Print(std::ostream& os=std::cout);
+
+private:
+  std::vector<Command::DoubleUnitArg*> _cut;
+  std::vector<Command::DoubleUnitArg*> _step;
+  Command::NoArg* _print;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -274,6 +297,12 @@ G4RotationMatrix Matrix(const double mxx,
                         const double mzz);
 //----------------------------------------------------------------------------------------------
 
+//__World Bounding Box of Named Volumes (Trailing * Matches Prefix)____________________________
+bool GlobalExtent(const std::string& name,
+                  G4ThreeVector& min,
+                  G4ThreeVector& max);
+//----------------------------------------------------------------------------------------------
+
 //__GDML File Export____________________________________________________________________________
 void Export(const G4LogicalVolume* volume,
             const std::string& dir,
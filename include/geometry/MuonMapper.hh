@@ -20,9 +20,12 @@
 #pragma once
 
 #include "G4VSensitiveDetector.hh"
+#include "G4ThreeVector.hh"
 
 #include "geometry/Construction.hh"
 
+class TFile;
+
 namespace MATHUSLA { namespace MU {
 
 namespace MuonMapper { /////////////////////////////////////////////////////////////////////////
@@ -48,8 +51,18 @@ public:
   static G4VPhysicalVolume* ConstructEarth(G4LogicalVolume* world);
 
   static bool SaveAll;
+
+private:
+  bool _survived;
+  double _exit_energy;
+  G4ThreeVector _exit_direction;
 };
 
+//__Write Muon Transfer Map Histograms and Lookup Table_________________________________________
+void SaveMap(TFile* file,
+             const std::string& path);
+//----------------------------------------------------------------------------------------------
+
 } /* namespace MuonMapper */ ///////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
@@ -0,0 +1,79 @@
+/*
+ * include/physics/Acceptance.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_ACCEPTANCE_HH
+#define MU__PHYSICS_ACCEPTANCE_HH
+#pragma once
+
+#include <vector>
+
+#include "physics/Particle.hh"
+#include "ui.hh"
+
+class TFile;
+
+namespace MATHUSLA { namespace MU {
+
+namespace Acceptance { /////////////////////////////////////////////////////////////////////////
+
+//__Acceptance Prefilter Messenger______________________________________________________________
+class Messenger : public G4UImessenger {
+public:
+  Messenger();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::BoolArg*       _active;
+  Command::StringArg*     _mode;
+  Command::StringArg*     _envelope;
+  Command::DoubleUnitArg* _margin;
+  Command::NoArg*         _print;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Enable Acceptance Prefilter Commands________________________________________________________
+void Enable();
+bool IsActive();
+//----------------------------------------------------------------------------------------------
+
+//__Select Generated Particles Heading into the Detector Envelope_______________________________
+// when dropping, keep is false for charged particles whose straight line misses the envelope
+// and for every particle of an event whose charged particles all miss it, which returns false
+bool Select(const Physics::ParticleVector& particles,
+            std::vector<bool>& keep);
+bool Select(const Physics::Particle& particle);
+//----------------------------------------------------------------------------------------------
+
+//__Acceptance Prefilter Counters_______________________________________________________________
+std::size_t EventCount();
+std::size_t RejectedEventCount();
+std::size_t DroppedParticleCount();
+void ResetCounters();
+//----------------------------------------------------------------------------------------------
+
+//__Write Acceptance Settings and Efficiency____________________________________________________
+void Save(TFile* file);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Acceptance */ ///////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_ACCEPTANCE_HH */
@@ -0,0 +1,142 @@
+/* include/physics/Biasing.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_BIASING_HH
+#define MU__PHYSICS_BIASING_HH
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <G4ThreeVector.hh>
+#include <G4VPhysicsConstructor.hh>
+
+#include "ui.hh"
+
+class TFile;
+
+namespace MATHUSLA { namespace MU {
+
+namespace Biasing { ////////////////////////////////////////////////////////////////////////////
+
+//__Cross-Section Biasing Messenger_____________________________________________________________
+class Messenger : public G4UImessenger {
+public:
+  Messenger();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::DoubleArg*  _factor;
+  Command::StringArg*  _processes;
+  Command::StringArg*  _particles;
+  Command::IntegerArg* _depth;
+  Command::IntegerArg* _limit;
+  Command::NoArg*      _print;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Forced Decay Messenger______________________________________________________________________
+class DecayMessenger : public G4UImessenger {
+public:
+  DecayMessenger();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::ThreeVectorUnitArg* _zone_min;
+  Command::ThreeVectorUnitArg* _zone_max;
+  Command::NoArg*              _print;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Importance Sampling Messenger_______________________________________________________________
+class ImportanceMessenger : public G4UImessenger {
+public:
+  ImportanceMessenger();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::StringArg* _set;
+  Command::NoArg*     _clear;
+  Command::NoArg*     _print;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Enable Cross-Section Biasing for Wrapped Particles__________________________________________
+void Enable(const std::vector<std::string>& wrapped);
+bool IsEnabled();
+const std::vector<std::string>& Wrapped();
+//----------------------------------------------------------------------------------------------
+
+//__Attach Biasing Operator to Logical Volume (Once per Thread)_________________________________
+void Attach(const std::string& volume);
+//----------------------------------------------------------------------------------------------
+
+//__Enable Forced Decay in the Decay Zone_______________________________________________________
+void EnableForcedDecay();
+bool IsForcedDecayEnabled();
+//----------------------------------------------------------------------------------------------
+
+//__Attach Forced Decay Operator to Unbiased Volumes (Once per Thread)__________________________
+void AttachForcedDecay();
+//----------------------------------------------------------------------------------------------
+
+//__Enable Geometric Importance Sampling for Particle (Before Initialization)___________________
+G4VPhysicsConstructor* EnableImportanceSampling(const std::string& particle);
+bool IsImportanceSampled(const std::string& particle);
+//----------------------------------------------------------------------------------------------
+
+//__Fill Importance Store from Volume Importances (Once per Thread and Run)_____________________
+void ApplyImportances();
+//----------------------------------------------------------------------------------------------
+
+//__Decay Zone Geometry_________________________________________________________________________
+bool InDecayZone(const G4ThreeVector& position);
+double DistanceToDecayZoneExit(const G4ThreeVector& position,
+                               const G4ThreeVector& direction);
+//----------------------------------------------------------------------------------------------
+
+//__Biasing Settings____________________________________________________________________________
+double Factor();
+bool IsBiasedProcess(const std::string& process);
+bool IsBiasedParticle(const std::string& particle);
+int Depth();
+int InteractionLimit();
+//----------------------------------------------------------------------------------------------
+
+//__Biased Interaction and Forced Decay Counters________________________________________________
+void CountInteraction();
+std::size_t InteractionCount();
+void CountForcedDecay();
+std::size_t ForcedDecayCount();
+void ResetCounters();
+//----------------------------------------------------------------------------------------------
+
+//__Write Biasing Settings______________________________________________________________________
+void Save(TFile* file);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Biasing */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_BIASING_HH */
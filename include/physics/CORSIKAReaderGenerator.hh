@@ -20,6 +20,9 @@
 #define MU__PHYSICS_CORSIKA_READER_GENERATOR_HH
 #pragma once
 
+#include <map>
+#include <set>
+
 #include "Generator.hh"
 
 namespace MATHUSLA { namespace MU {
@@ -81,6 +84,10 @@ public:
   void SetNewValue(G4UIcommand* command,
                    G4String value);
   void SetFile(const std::string& path);
+  void SetStream(const std::string& paths);
+  bool Cull(const Particle& particle);
+  bool CullFootprint(const Particle& particle,
+                     const double spread=0);
 
   virtual const Analysis::SimSettingList GetSpecification() const;
   virtual const std::vector<std::vector<double>> ExtraDetails() const;
@@ -91,9 +98,29 @@ private:
   CORSIKAConfig _config;
   std::pair<double, double> _translation;
   std::string _path;
+  std::size_t _dethin_cap;
+  double _dethin_radius, _dethin_angle;
+  bool _streaming, _interleave;
+  std::size_t _shower_count, _tree_cache;
+  double _cull_radius;
+  std::map<int, double> _cull_energy;
+  std::set<int> _cull_particles;
+  bool _cull_center_loaded;
+  std::pair<double, double> _cull_center;
+  std::size_t _cull_read, _culled_type, _culled_energy, _culled_footprint;
   Command::StringArg* _read_file;
+  Command::StringArg* _stream_files;
+  Command::StringArg* _set_partition;
+  Command::IntegerArg* _set_tree_cache;
   Command::DoubleUnitArg* _set_max_radius;
   Command::IntegerArg* _set_event_id;
+  Command::IntegerArg* _set_dethin;
+  Command::DoubleUnitArg* _set_dethin_radius;
+  Command::DoubleUnitArg* _set_dethin_angle;
+  Command::DoubleUnitArg* _set_cull_radius;
+  Command::StringArg* _set_cull_energy;
+  Command::StringArg* _set_cull_particles;
+  Command::NoArg* _clear_culls;
 };
 //----------------------------------------------------------------------------------------------
 
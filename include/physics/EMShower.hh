@@ -0,0 +1,109 @@
+/*
+ * include/physics/EMShower.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_EM_SHOWER_HH
+#define MU__PHYSICS_EM_SHOWER_HH
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <G4VFastSimulationModel.hh>
+
+#include "ui.hh"
+
+class TFile;
+
+namespace MATHUSLA { namespace MU {
+
+namespace EMShower { ///////////////////////////////////////////////////////////////////////////
+
+//__Parameterised EM Showers in Passive Material________________________________________________
+class Model : public G4VFastSimulationModel {
+public:
+  Model(const G4String& name,
+        G4Region* envelope);
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle);
+  G4bool ModelTrigger(const G4FastTrack& track);
+  void DoIt(const G4FastTrack& track, G4FastStep& step);
+
+  struct Medium {
+    double radiation_length, moliere_radius, critical_energy, z;
+  };
+
+  struct Profile {
+    double t_max, alpha, beta;
+    double core_radius, tail_radius, core_fraction;
+  };
+
+private:
+  const Medium& _medium(const G4Material* material);
+  Profile _profile(const Medium& medium,
+                   const double energy,
+                   const bool photon,
+                   const double tau) const;
+  double _containment_depth(const Medium& medium,
+                            const double energy,
+                            const bool photon) const;
+
+  std::unordered_map<const G4Material*, Medium> _media;
+  const Medium* _current;
+};
+//----------------------------------------------------------------------------------------------
+
+//__EM Shower Parameterisation Messenger________________________________________________________
+class Messenger : public G4UImessenger {
+public:
+  Messenger();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::BoolArg*       _active;
+  Command::DoubleUnitArg* _emin;
+  Command::IntegerArg*    _spots;
+  Command::NoArg*         _print;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Enable EM Shower Parameterisation___________________________________________________________
+void Enable();
+bool IsEnabled();
+//----------------------------------------------------------------------------------------------
+
+//__Attach Model to Passive Regions (Once per Thread)___________________________________________
+void Attach(const std::vector<std::string>& regions={"Steel", "Concrete"});
+//----------------------------------------------------------------------------------------------
+
+//__Parameterised Shower Counters_______________________________________________________________
+std::size_t ShowerCount();
+double ShowerEnergy();
+void ResetCounters();
+//----------------------------------------------------------------------------------------------
+
+//__Write Deposit Profiles and Reset____________________________________________________________
+void Save(TFile* file);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace EMShower */ /////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_EM_SHOWER_HH */
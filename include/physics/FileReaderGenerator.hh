@@ -9,10 +9,13 @@
 #include <string>
 #include <iostream>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace MATHUSLA { namespace MU { namespace Physics {
 
+class ParticleFile;
+
 class FileReaderGenerator : public Generator {
 public:
   FileReaderGenerator(const std::string &name, const std::string &description);
@@ -27,12 +30,18 @@ public:
 protected:
   virtual void GenerateCommands();
 
-  std::size_t _event_counter = 0;
-  std::vector<Particle> _particle_parameters;
+  std::shared_ptr<ParticleFile> _particle_file;
+  std::vector<Particle> _event_particles;
+  std::vector<double> _event_weights;
+  std::vector<bool> _event_keep;
 
   Command::StringArg *_ui_pathname;
 };
 
+// Converts a particle parameters file, text or binary, to the binary format and returns the
+// number of events written.
+std::size_t ConvertParticleFile(const std::string &input, const std::string &output);
+
 } } } // namespace MATHUSLA::MU::Physics
 
 #endif // MU__PHYSICS__FILE_READER_GENERATOR_HH
@@ -136,6 +136,40 @@ protected:
 };
 //----------------------------------------------------------------------------------------------
 
+//__Energy and Angle Grid Generator for Muon Transfer Maps______________________________________
+class MapGenerator : public Generator {
+public:
+  MapGenerator(const std::string& name,
+               const std::string& description,
+               const Particle& particle);
+
+  virtual ~MapGenerator() = default;
+
+  virtual void GeneratePrimaryVertex(G4Event* event);
+  virtual void SetNewValue(G4UIcommand* command,
+                           G4String value);
+  virtual std::ostream& Print(std::ostream& os=std::cout) const;
+  virtual const Analysis::SimSettingList GetSpecification() const;
+
+  std::size_t size() const { return _energies.size() * _angles.size(); }
+  std::size_t count() const { return _count; }
+  std::size_t point(std::size_t event_id) const;
+  double energy(std::size_t point) const;
+  double angle(std::size_t point) const;
+  double path(std::size_t point) const;
+
+protected:
+  virtual void GenerateCommands();
+
+  std::vector<double> _energies, _angles;
+  std::size_t _count;
+
+  Command::StringArg*  _ui_energies;
+  Command::StringArg*  _ui_angles;
+  Command::IntegerArg* _ui_count;
+};
+//----------------------------------------------------------------------------------------------
+
 //__Stream Operator for Generators______________________________________________________________
 inline std::ostream& operator<<(std::ostream& os,
                                 const Generator& generator) {
@@ -0,0 +1,123 @@
+/* include/physics/MuonTransport.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_MUON_TRANSPORT_HH
+#define MU__PHYSICS_MUON_TRANSPORT_HH
+#pragma once
+
+#include <unordered_map>
+
+#include <G4VFastSimulationModel.hh>
+#include <G4Navigator.hh>
+#include <G4Step.hh>
+
+#include "ui.hh"
+
+class TFile;
+
+namespace MATHUSLA { namespace MU {
+
+namespace MuonTransport { ///////////////////////////////////////////////////////////////////////
+
+//__Parameterised Muon Transport through Rock___________________________________________________
+class Model : public G4VFastSimulationModel {
+public:
+  Model(G4Region* envelope);
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle);
+  G4bool ModelTrigger(const G4FastTrack& track);
+  void DoIt(const G4FastTrack& track, G4FastStep& step);
+
+  struct Table {
+    std::vector<double> energy, range;
+    double radiation_length, electron_density;
+  };
+
+  struct Segment {
+    const G4Material* material;
+    double length;
+  };
+
+  struct Result {
+    G4ThreeVector position, direction;
+    double kinetic_energy, time, path_length, deposit;
+    bool stopped;
+  };
+
+private:
+  const Table& _table(const G4ParticleDefinition* particle,
+                      const G4Material* material);
+  bool _walk(const G4ThreeVector& position,
+             const G4ThreeVector& direction);
+  Result _transport(const G4Track& track);
+
+  G4Navigator _navigator;
+  std::size_t _geometry_version;
+  std::unordered_map<const G4Material*, Table> _tables[2];
+  std::vector<Segment> _segments;
+  G4ThreeVector _exit_normal;
+  Result _result;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Messenger____________________________________________________________________
+class Messenger : public G4UImessenger {
+public:
+  Messenger();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::StringArg*     _materials;
+  Command::StringArg*     _table;
+  Command::DoubleUnitArg* _emin;
+  Command::DoubleUnitArg* _min_path;
+  Command::BoolArg*       _validate;
+  Command::NoArg*         _print;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Enable Parameterised Muon Transport_________________________________________________________
+void Enable();
+bool IsEnabled();
+//----------------------------------------------------------------------------------------------
+
+//__Attach Model to Envelope Region (Once per Thread)___________________________________________
+void Attach(const std::string& region="Earth");
+//----------------------------------------------------------------------------------------------
+
+//__Record Full Tracking Exit for Validation____________________________________________________
+bool Validating();
+void Observe(const G4Step* step);
+//----------------------------------------------------------------------------------------------
+
+//__Transport Counters__________________________________________________________________________
+std::size_t TransportedCount();
+std::size_t StoppedCount();
+void ResetCounters();
+//----------------------------------------------------------------------------------------------
+
+//__Write Exit Distributions and Reset__________________________________________________________
+void Save(TFile* file);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace MuonTransport */ ////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_MUON_TRANSPORT_HH */
@@ -191,7 +191,8 @@ using ParticleVector = std::vector<Particle>;
 
 //__Add Momentum and Vertex Particle To Event___________________________________________________
 void AddParticle(const Particle& particle,
-                 G4Event& event);
+                 G4Event& event,
+                 const double weight=1.0);
 //----------------------------------------------------------------------------------------------
 
 struct GenParticle {
@@ -203,21 +204,22 @@ struct GenParticle {
   Pythia8::Vec4 vertex;
   double m;
   int G4index;
+  double weight;
   
   GenParticle() : index(-1), pdgid(0), status(-1), moid1(-1), moid2(-1), dau1(-1), dau2(-1),
 		  mom(Pythia8::Vec4(0.,0.,0.,0.)), hasVertex(false), vertex(Pythia8::Vec4(0.,0.,0.,0.)),
-		  m(0.0), G4index(-1) {}
+		  m(0.0), G4index(-1), weight(1.0) {}
 
   GenParticle(const Particle& p) : index(-1), pdgid(p.id), status(-1), moid1(-1), moid2(-1),
 				   dau1(-1), dau2(-1), mom(Pythia8::Vec4(p.px,p.py,p.pz,p.e())),
 				   hasVertex(true), vertex(Pythia8::Vec4(p.x,p.y,p.z,p.t)),
-				   m(p.mass()), G4index(-1) {}
+				   m(p.mass()), G4index(-1), weight(1.0) {}
 							   
   
   GenParticle(const Pythia8::Particle& p) : index(p.index()), pdgid(p.id()), status(p.status()),
 					    moid1(p.mother1()), moid2(p.mother2()), dau1(p.daughter1()),
 					    dau2(p.daughter2()), mom(p.p()), hasVertex(p.hasVertex()),
-					    vertex(p.vProd()), m(p.m()), G4index(-1) {}
+					    vertex(p.vProd()), m(p.m()), G4index(-1), weight(1.0) {}
 };
   
 
@@ -0,0 +1,60 @@
+/*
+ * include/physics/PhysicsCache.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_PHYSICS_CACHE_HH
+#define MU__PHYSICS_PHYSICS_CACHE_HH
+#pragma once
+
+#include <string>
+
+#include <G4VStateDependent.hh>
+
+class TFile;
+
+namespace MATHUSLA { namespace MU {
+
+namespace PhysicsCache { ///////////////////////////////////////////////////////////////////////
+
+//__Physics Table Cache Hook before and after Table Building____________________________________
+class StateHook : public G4VStateDependent {
+public:
+  StateHook();
+  G4bool Notify(G4ApplicationState requested);
+};
+//----------------------------------------------------------------------------------------------
+
+//__Enable Physics Table Cache (Before Initialization)__________________________________________
+void Enable(const std::string& directory,
+            const std::string& physics);
+bool IsEnabled();
+//----------------------------------------------------------------------------------------------
+
+//__Physics Table Cache Key and Status__________________________________________________________
+const std::string& Key();
+bool Retrieved();
+//----------------------------------------------------------------------------------------------
+
+//__Write Physics Table Cache Status____________________________________________________________
+void Save(TFile* file);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace PhysicsCache */ /////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_PHYSICS_CACHE_HH */
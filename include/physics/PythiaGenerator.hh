@@ -101,11 +101,15 @@ namespace MATHUSLA { namespace MU {
 	PythiaFilter* _filter;
 	GenParticleVector _last_event;
 	std::uint_fast64_t _counter;
+	std::uint_fast64_t _cache_trials;
 	std::string _path;
 	Command::StringArg* _read_string;
 	Command::StringArg* _read_file;
 	Command::StringArg* _add_filter;
 	Command::StringArg* _add_filter_cut;
+	Command::IntegerArg* _set_producers;
+	Command::IntegerArg* _set_queue;
+	Command::StringArg* _cache_events;
       };
       //----------------------------------------------------------------------------------------------
       
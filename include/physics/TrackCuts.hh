@@ -0,0 +1,134 @@
+/*
+ * include/physics/TrackCuts.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_TRACK_CUTS_HH
+#define MU__PHYSICS_TRACK_CUTS_HH
+#pragma once
+
+#include <ctime>
+#include <unordered_map>
+
+#include <G4ThreeVector.hh>
+#include <G4VDiscreteProcess.hh>
+#include <G4VPhysicsConstructor.hh>
+
+#include "ui.hh"
+
+class G4MaterialCutsCouple;
+class TFile;
+
+namespace MATHUSLA { namespace MU {
+
+namespace TrackCuts { //////////////////////////////////////////////////////////////////////////
+
+//__Time, Kinetic Energy and Range-Out Cut Process______________________________________________
+class Process : public G4VDiscreteProcess {
+public:
+  Process();
+
+  struct Cut {
+    double max_time, min_energy;
+    bool range_out;
+  };
+
+  G4bool IsApplicable(const G4ParticleDefinition&) { return true; }
+  void StartTracking(G4Track* track);
+  void EndTracking();
+  G4double PostStepGetPhysicalInteractionLength(const G4Track& track,
+                                                G4double previous_step_size,
+                                                G4ForceCondition* condition);
+  G4VParticleChange* PostStepDoIt(const G4Track& track,
+                                  const G4Step& step);
+
+protected:
+  G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*) { return DBL_MAX; }
+
+private:
+  enum Reason { None, Time, Energy, Range };
+
+  Reason _reason(const G4Track& track);
+  bool _out_of_range(const G4Track& track);
+  bool _load_envelope();
+  void _flag(const G4Track& track);
+
+  const Cut* _cut;
+  Reason _kill_reason;
+  std::size_t _envelope_version, _geometry_version;
+  bool _envelope_loaded;
+  const G4MaterialCutsCouple* _lightest_couple;
+  G4ThreeVector _envelope_min, _envelope_max;
+  bool _flagged;
+  std::clock_t _flag_clock;
+  int _event_id;
+  std::unordered_map<int, double> _flagged_tracks;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Track Cut Physics Constructor_______________________________________________________________
+class Physics : public G4VPhysicsConstructor {
+public:
+  Physics();
+  void ConstructParticle() {}
+  void ConstructProcess();
+};
+//----------------------------------------------------------------------------------------------
+
+//__Track Cut Messenger_________________________________________________________________________
+class Messenger : public G4UImessenger {
+public:
+  Messenger();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::StringArg*     _time_cut;
+  Command::StringArg*     _emin_cut;
+  Command::DoubleUnitArg* _neutron_emin;
+  Command::StringArg*     _range_cut;
+  Command::DoubleUnitArg* _range_margin;
+  Command::StringArg*     _range_envelope;
+  Command::NoArg*         _clear;
+  Command::BoolArg*       _validate;
+  Command::NoArg*         _print;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Enable Track Cuts___________________________________________________________________________
+void Enable();
+bool IsEnabled();
+bool Validating();
+//----------------------------------------------------------------------------------------------
+
+//__Killed Track Counters_______________________________________________________________________
+std::size_t TimeKilledCount();
+std::size_t EnergyKilledCount();
+std::size_t RangeKilledCount();
+void ResetCounters();
+//----------------------------------------------------------------------------------------------
+
+//__Write Track Cut Settings and CPU Summary____________________________________________________
+void Save(TFile* file,
+          double cpu_time);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace TrackCuts */ ////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_TRACK_CUTS_HH */
@@ -0,0 +1,58 @@
+/* include/scoring.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__SCORING_HH
+#define MU__SCORING_HH
+#pragma once
+
+#include "ui.hh"
+
+class TFile;
+
+namespace MATHUSLA { namespace MU {
+
+namespace Scoring { ////////////////////////////////////////////////////////////////////////////
+
+//__Scoring Mesh Messenger______________________________________________________________________
+class Messenger : public G4UImessenger {
+public:
+  Messenger();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  Command::StringArg* _particles;
+  Command::StringArg* _volume;
+  Command::NoArg*     _list;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Enable Scoring Meshes_______________________________________________________________________
+void Enable();
+bool IsEnabled();
+//----------------------------------------------------------------------------------------------
+
+//__Write Merged Meshes as Histograms and Reset_________________________________________________
+void Save(TFile* file);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Scoring */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__SCORING_HH */
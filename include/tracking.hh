@@ -43,7 +43,9 @@ public:
       const std::string& chamber,
       const double deposit,
       const G4LorentzVector position,
-      const G4LorentzVector momentum);
+      const G4LorentzVector momentum,
+      const double weight=1.0,
+      const double pre_step_weight=1.0);
 
   Hit(const G4Step* step, bool post=true);
 
@@ -59,6 +61,8 @@ public:
   double                 GetDeposit()      const { return _deposit;                     }
   const G4LorentzVector& GetPosition()     const { return _position;                    }
   const G4LorentzVector& GetMomentum()     const { return _momentum;                    }
+  double                 GetWeight()       const { return _weight;                      }
+  double                 GetPreStepWeight() const { return _pre_step_weight;            }
 
   bool operator==(const Hit& rhs) const {
     return this == &rhs;
@@ -81,6 +85,8 @@ private:
   double _deposit;
   G4LorentzVector _position;
   G4LorentzVector _momentum;
+  double _weight;
+  double _pre_step_weight;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -24,11 +24,14 @@
 #include <iostream>
 #include <fstream>
 
+#include "physics/Biasing.hh"
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 ChangeCrossSection::ChangeCrossSection(G4String particleName,
                                                          G4String         name)
   : G4VBiasingOperator(name),
+    fXStransformation(1.0),
     fSetup(true)
 {
   fParticleToBias = G4ParticleTable::GetParticleTable()->FindParticle(particleName);
@@ -63,7 +66,7 @@ void ChangeCrossSection::StartRun()
   // ---------------
   // -- Start by collecting processes under biasing, create needed biasing
   // -- operations and associate these operations to the processes:
-  if ( fSetup )
+  if ( fSetup && fParticleToBias )
     {
       const G4ProcessManager* processManager = fParticleToBias->GetProcessManager();
       const G4BiasingProcessSharedData* sharedData =
@@ -83,6 +86,30 @@ void ChangeCrossSection::StartRun()
         }
       fSetup = false;
     }
+
+  // -- Select the processes to bias and fetch the cross-section factor for this run:
+  fBiasedProcesses.clear();
+  fBiasedOperations.clear();
+  for ( std::map< const G4BiasingProcessInterface*, G4BOptnChangeCrossSection* >::iterator
+          it = fChangeCrossSectionOperations.begin() ;
+        it != fChangeCrossSectionOperations.end() ;
+        it++ )
+    {
+      if ( !MATHUSLA::MU::Biasing::IsBiasedProcess( (*it).first->GetWrappedProcess()->GetProcessName() ) ) continue;
+      fBiasedProcesses.push_back( (*it).first );
+      fBiasedOperations.push_back( (*it).second );
+    }
+  fXStransformation = MATHUSLA::MU::Biasing::Factor();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4BOptnChangeCrossSection*
+ChangeCrossSection::GetBiasedOperation( const G4BiasingProcessInterface* callingProcess ) const
+{
+  for ( size_t i = 0 ; i < fBiasedProcesses.size() ; i++ )
+    if ( fBiasedProcesses[i] == callingProcess ) return fBiasedOperations[i];
+  return 0;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -93,13 +120,15 @@ ChangeCrossSection::ProposeOccurenceBiasingOperation(const G4Track*            t
                                                                                callingProcess)
 {
 
-  if (callingProcess->GetWrappedProcess()->GetProcessName() != "muonNuclear") return 0;
-
   // -----------------------------------------------------
   // -- Check if current particle type is the one to bias:
   // -----------------------------------------------------
   if ( track->GetDefinition() != fParticleToBias ) return 0;
 
+  // -- fetch the operation associated to this callingProcess, if it is biased:
+  G4BOptnChangeCrossSection* operation = GetBiasedOperation( callingProcess );
+  if ( operation == 0 ) return 0;
+
   // ---------------------------------------------------------------------
   // -- select and setup the biasing operation for current callingProcess:
   // ---------------------------------------------------------------------
@@ -112,13 +141,11 @@ ChangeCrossSection::ProposeOccurenceBiasingOperation(const G4Track*            t
   // -- Analog cross-section is well-defined:
   G4double analogXS = 1./analogInteractionLength;
 
-  // -- Choose a constant cross-section bias. But at this level, this factor can be made
+  // -- Constant cross-section bias set by /bias/factor. But at this level, this factor can be made
   // -- direction dependent, like in the exponential transform MCNP case, or it
   // -- can be chosen differently, depending on the process, etc.
-  G4double XStransformation = 5000.0 ;
+  const G4double XStransformation = fXStransformation;
 
-  // -- fetch the operation associated to this callingProcess:
-  G4BOptnChangeCrossSection*   operation = fChangeCrossSectionOperations[callingProcess];
   // -- get the operation that was proposed to the process in the previous step:
   G4VBiasingOperation* previousOperation = callingProcess->GetPreviousOccurenceBiasingOperation();
 
@@ -183,8 +210,8 @@ OperationApplied(const G4BiasingProcessInterface*           callingProcess,
                  G4VBiasingOperation*,
                  const G4VParticleChange*                                  )
 {
-  G4BOptnChangeCrossSection* operation = fChangeCrossSectionOperations[callingProcess];
-  if ( operation ==  occurenceOperationApplied ) operation->SetInteractionOccured();
+  G4BOptnChangeCrossSection* operation = GetBiasedOperation( callingProcess );
+  if ( operation != 0 && operation == occurenceOperationApplied ) operation->SetInteractionOccured();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
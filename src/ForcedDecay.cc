@@ -0,0 +1,97 @@
+
+//
+//-----------------------------------------------------------------
+//
+// Forced decay of particles inside the fiducial decay zone, in the
+// style of the G4 example GB01 operators
+//
+//-----------------------------------------------------------------
+//
+
+#include "ForcedDecay.hh"
+#include "ForcedDecayOperation.hh"
+#include "G4BiasingProcessInterface.hh"
+
+#include "G4DecayProcessType.hh"
+#include "G4VProcess.hh"
+
+#include "physics/Biasing.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ForcedDecay::ForcedDecay(G4String name)
+  : G4VBiasingOperator(name),
+    fForcing(false),
+    fDone(false)
+{
+  fForcedDecayOperation = new ForcedDecayOperation("ForcedDecay");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ForcedDecay::~ForcedDecay()
+{
+  delete fForcedDecayOperation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VBiasingOperation*
+ForcedDecay::ProposeOccurenceBiasingOperation(const G4Track*                    track,
+                                              const G4BiasingProcessInterface* callingProcess)
+{
+  // -- only the decay in flight is forced, at most once per track:
+  if ( fDone ) return 0;
+  if ( callingProcess->GetWrappedProcess()->GetProcessSubType() != DECAY ) return 0;
+
+  if ( fForcing )
+    {
+      // -- the interaction law was sampled on entering the zone; if the decay did not
+      // -- happen in the previous step, consume the step length from the law:
+      if ( callingProcess->GetPreviousOccurenceBiasingOperation() == fForcedDecayOperation &&
+           !fForcedDecayOperation->GetInteractionOccured() )
+        fForcedDecayOperation->UpdateForStep( callingProcess->GetPreviousStepSize() );
+      return fForcedDecayOperation;
+    }
+
+  // -- start forcing once the track is inside the zone, over its straight path to the exit:
+  const G4double distance = MATHUSLA::MU::Biasing::DistanceToDecayZoneExit( track->GetPosition(),
+                                                                            track->GetMomentumDirection() );
+  if ( distance <= 0. ) return 0;
+
+  // -- particles without an analog decay length in flight are left alone:
+  const G4double analogInteractionLength = callingProcess->GetWrappedProcess()->GetCurrentInteractionLength();
+  if ( analogInteractionLength > DBL_MAX/10. ) return 0;
+
+  fForcedDecayOperation->Setup( 1./analogInteractionLength, distance );
+  fForcing = true;
+  return fForcedDecayOperation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ForcedDecay::StartTracking( const G4Track* )
+{
+  fForcing = false;
+  fDone    = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void
+ForcedDecay::
+OperationApplied( const G4BiasingProcessInterface*,
+                  G4BiasingAppliedCase,
+                  G4VBiasingOperation*                occurenceOperationApplied,
+                  G4double,
+                  G4VBiasingOperation*,
+                  const G4VParticleChange* )
+{
+  if ( occurenceOperationApplied != fForcedDecayOperation ) return;
+  fForcedDecayOperation->SetInteractionOccured();
+  fForcing = false;
+  fDone    = true;
+  MATHUSLA::MU::Biasing::CountForcedDecay();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
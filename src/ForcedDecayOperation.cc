@@ -0,0 +1,59 @@
+
+//
+//-----------------------------------------------------------------
+//
+// Occurence biasing operation forcing an interaction within a
+// given distance, following G4BOptnChangeCrossSection
+//
+//-----------------------------------------------------------------
+//
+
+#include "ForcedDecayOperation.hh"
+#include "G4ILawTruncatedExp.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ForcedDecayOperation::ForcedDecayOperation(G4String name)
+  : G4VBiasingOperation(name),
+    fInteractionOccured(false)
+{
+  fTruncatedExpLaw = new G4ILawTruncatedExp("LawForOperation"+name);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ForcedDecayOperation::~ForcedDecayOperation()
+{
+  if ( fTruncatedExpLaw ) delete fTruncatedExpLaw;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4VBiasingInteractionLaw*
+ForcedDecayOperation::ProvideOccurenceBiasingInteractionLaw( const G4BiasingProcessInterface*,
+                                                             G4ForceCondition& )
+{
+  return fTruncatedExpLaw;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ForcedDecayOperation::Setup( G4double analogCrossSection, G4double maximumDistance )
+{
+  // -- the interaction point is sampled from the analog exponential law truncated
+  // -- at maximumDistance; the weight 1-exp(-analogCrossSection*maximumDistance)
+  // -- follows from the ratio of the analog and biased laws in the process interface:
+  fTruncatedExpLaw->SetForceCrossSection( analogCrossSection );
+  fTruncatedExpLaw->SetMaximumDistance( maximumDistance );
+  fTruncatedExpLaw->Sample();
+  fInteractionOccured = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ForcedDecayOperation::UpdateForStep( G4double truePathLength )
+{
+  fTruncatedExpLaw->UpdateForStep( truePathLength );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -14,11 +14,21 @@
 #include "G4ParticleTable.hh"
 
 #include "G4SystemOfUnits.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+
+#include "physics/Biasing.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 MultiParticleChangeCrossSection::MultiParticleChangeCrossSection()
-  : G4VBiasingOperator("TestManyExponentialTransform")
+  : G4VBiasingOperator("TestManyExponentialTransform"),
+    fCurrentOperator(0),
+    fnInteractions(0),
+    fGeneration(0),
+    fDepth(0),
+    fInteractionLimit(2),
+    fEventID(-1)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -41,29 +51,42 @@ void MultiParticleChangeCrossSection::AddParticle(G4String particleName)
 
   ChangeCrossSection* optr = new ChangeCrossSection(particleName);
   fParticlesToBias.push_back( particle );
-  fBOptrForParticle[ particle ] = optr;
+  fBOptrForParticle.push_back( optr );
+  fParticleBiased.push_back( true );
 
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void MultiParticleChangeCrossSection::StartRun()
+{
+  // -- fetch the /bias/ settings for this run:
+  for ( size_t i = 0 ; i < fParticlesToBias.size() ; i++ )
+    fParticleBiased[i] = MATHUSLA::MU::Biasing::IsBiasedParticle( fParticlesToBias[i]->GetParticleName() );
+  fDepth            = MATHUSLA::MU::Biasing::Depth();
+  fInteractionLimit = MATHUSLA::MU::Biasing::InteractionLimit();
+  fGenerations.clear();
+  fEventID = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 G4VBiasingOperation*
 MultiParticleChangeCrossSection::
 ProposeOccurenceBiasingOperation(const G4Track* track,
                                  const G4BiasingProcessInterface* callingProcess)
 {
-  // -- examples of limitations imposed to apply the biasing:
-  // -- limit application of biasing to primary particles only:
-  if ( track->GetParentID() != 0 ) return 0;
-  // -- limit to at most 2 biased interactions:
-  if ( fnInteractions > 1)         return 0;
+  if ( fCurrentOperator == 0 ) return 0;
+
+  // -- limitations imposed to apply the biasing (/bias/depth and /bias/limit, -1 for none):
+  // -- limit application of biasing to the first generations of particles:
+  if ( fDepth >= 0 && fGeneration > fDepth ) return 0;
+  // -- limit the number of biased interactions:
+  if ( fInteractionLimit >= 0 && fnInteractions >= fInteractionLimit ) return 0;
   // -- and limit to a weight of at least 0.05:
   // if ( track->GetWeight() < 0.05 ) return 0;
-  // std::cout << "WWW: " << track->GetWeight() << " f : " << fnInteractions << "\n";
 
-  if ( fCurrentOperator ) return fCurrentOperator->
-                            GetProposedOccurenceBiasingOperation(track, callingProcess);
-  else                    return 0;
+  return fCurrentOperator->GetProposedOccurenceBiasingOperation(track, callingProcess);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -72,14 +95,43 @@ void MultiParticleChangeCrossSection::StartTracking( const G4Track* track )
 {
   // -- fetch the underneath biasing operator, if any, for the current particle type:
   const G4ParticleDefinition* definition = track->GetParticleDefinition();
-  std::map < const G4ParticleDefinition*, ChangeCrossSection* > :: iterator
-    it = fBOptrForParticle.find( definition );
   fCurrentOperator = 0;
-  if ( it != fBOptrForParticle.end() ) fCurrentOperator = (*it).second;
+  for ( size_t i = 0 ; i < fParticlesToBias.size() ; i++ )
+    {
+      if ( fParticlesToBias[i] != definition ) continue;
+      if ( fParticleBiased[i] ) fCurrentOperator = fBOptrForParticle[i];
+      break;
+    }
 
   // -- reset count for number of biased interactions:
   fnInteractions = 0;
 
+  // -- find the generation of the track. Only tracks seen by this operator are remembered,
+  // -- so a secondary of an unbiased particle type counts as beyond any finite depth:
+  if ( fDepth > 0 )
+    {
+      const G4int eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+      if ( eventID != fEventID )
+        {
+          fGenerations.clear();
+          fEventID = eventID;
+        }
+    }
+  if ( track->GetParentID() == 0 )
+    {
+      fGeneration = 0;
+    }
+  else if ( fDepth <= 0 )
+    {
+      fGeneration = 1;
+    }
+  else
+    {
+      std::unordered_map < G4int, G4int > :: const_iterator
+        it = fGenerations.find( track->GetParentID() );
+      fGeneration = ( it != fGenerations.end() ) ? (*it).second + 1 : fDepth + 1;
+    }
+  if ( fDepth > 0 && fGeneration < fDepth ) fGenerations[ track->GetTrackID() ] = fGeneration;
 
 }
 
@@ -96,6 +148,7 @@ OperationApplied( const G4BiasingProcessInterface*               callingProcess,
 {
   // -- count number of biased interactions:
   fnInteractions++;
+  MATHUSLA::MU::Biasing::CountInteraction();
 
   // -- inform the underneath biasing operator that a biased interaction occured:
   if ( fCurrentOperator ) fCurrentOperator->ReportOperationApplied( callingProcess,
@@ -19,6 +19,8 @@
 
 #include <tls.hh>
 
+#include "physics/MuonTransport.hh"
+
 namespace MATHUSLA { namespace MU {
 
 bool ActionInitialization::Debug = false;
@@ -50,8 +52,9 @@ void ActionInitialization::Build() const {
   SetUserAction(new RunAction(_data_dir));
   SetUserAction(new EventAction(100));
   SetUserAction(new TrackingAction());
+  SetUserAction(new StackingAction());
   SetUserAction(new GeneratorAction(_generator));
-  if (Debug) SetUserAction(new StepAction());
+  if (Debug || MuonTransport::Validating()) SetUserAction(new StepAction());
 }
 //----------------------------------------------------------------------------------------------
 
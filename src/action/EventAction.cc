@@ -27,6 +27,7 @@ namespace { ////////////////////////////////////////////////////////////////////
 //__Printing Frequency for Event Count__________________________________________________________
 G4ThreadLocal size_t _print_modulo;
 G4ThreadLocal uint_fast64_t _event_id{};
+G4ThreadLocal double _event_weight = 1.0;
 //----------------------------------------------------------------------------------------------
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
@@ -39,6 +40,7 @@ EventAction::EventAction(const size_t print_modulo) : G4UserEventAction() {
 //__Event Initialization________________________________________________________________________
 void EventAction::BeginOfEventAction(const G4Event* event) {
   _event_id = event->GetEventID();
+  _event_weight = 1.0;
   std::cout << "\r  Event [ "
              + std::to_string(_event_id)
              + " ] @ ("
@@ -67,6 +69,18 @@ size_t EventAction::EventID() {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Get Current Event Weight____________________________________________________________________
+double EventAction::Weight() {
+  return _event_weight;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Scale Current Event Weight__________________________________________________________________
+void EventAction::ScaleWeight(double factor) {
+  _event_weight *= factor;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Event Initialization________________________________________________________________________
 void EventAction::EndOfEventAction(const G4Event* event) {
   if (ActionInitialization::Debug) StepAction::WriteTree(event->GetEventID());
@@ -58,6 +58,9 @@ GeneratorAction::GeneratorAction(const std::string& generator)
   _gen_map["polar"] = new Physics::PolarGenerator(
 	  "polar", "Default Polar Generator.", {});
 
+  _gen_map["map"] = new Physics::MapGenerator(
+      "map", "Muon Transfer Map Generator.", Physics::Particle(13, 0, 0, 100*m, 0, 0, -1*GeVperC));
+
   _gen_map["file_reader"] = new Physics::FileReaderGenerator(
       "file_reader", "File Reader Generator.");
 
@@ -0,0 +1,75 @@
+/*
+ * src/action/MuonFastPhysicsList.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MuonFastPhysicsList.hh"
+
+#include <G4EmStandardPhysics_option1.hh>
+#include <G4EmExtraPhysics.hh>
+#include <G4EmParameters.hh>
+#include <G4DecayPhysics.hh>
+#include <G4HadronElasticPhysics.hh>
+#include <G4HadronPhysicsFTFP_BERT.hh>
+#include <G4NeutronTrackingCut.hh>
+#include <G4StepLimiterPhysics.hh>
+#include <G4SystemOfUnits.hh>
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Tune EM Parameters for Muon Transport_______________________________________________________
+void _tune_em_parameters() {
+  auto parameters = G4EmParameters::Instance();
+  parameters->SetMscStepLimitType(fMinimal);
+  parameters->SetMscMuHadStepLimitType(fMinimal);
+  parameters->SetMscRangeFactor(0.2);
+  parameters->SetMscMuHadRangeFactor(0.4);
+  parameters->SetLowestMuHadEnergy(1*MeV);
+  parameters->SetLowestElectronEnergy(1*MeV);
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Muon Fast Physics List Constructor__________________________________________________________
+MuonFastPhysicsList::MuonFastPhysicsList(bool hadronic) : G4VModularPhysicsList() {
+  SetVerboseLevel(0);
+  defaultCutValue = 1*cm;
+
+  RegisterPhysics(new G4EmStandardPhysics_option1);
+  RegisterPhysics(new G4EmExtraPhysics);
+  RegisterPhysics(new G4DecayPhysics);
+
+  if (hadronic) {
+    RegisterPhysics(new G4HadronElasticPhysics);
+    RegisterPhysics(new G4HadronPhysicsFTFP_BERT);
+    RegisterPhysics(new G4NeutronTrackingCut);
+  }
+
+  RegisterPhysics(new G4StepLimiterPhysics);
+  _tune_em_parameters();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Production Cuts_________________________________________________________________________
+void MuonFastPhysicsList::SetCuts() {
+  SetCutsWithDefault();
+}
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace MATHUSLA::MU */
@@ -18,6 +18,9 @@
 
 #include "action.hh"
 
+#include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <fstream>
 #include <ostream>
 #include <thread>
@@ -34,7 +37,15 @@
 
 #include "analysis.hh"
 #include "geometry/Construction.hh"
+#include "geometry/MuonMapper.hh"
 #include "physics/Units.hh"
+#include "scoring.hh"
+#include "physics/MuonTransport.hh"
+#include "physics/Biasing.hh"
+#include "physics/TrackCuts.hh"
+#include "physics/PhysicsCache.hh"
+#include "physics/EMShower.hh"
+#include "physics/Acceptance.hh"
 
 #include "MuonDataController.hh"
 #include "util/io.hh"
@@ -60,6 +71,11 @@ std::size_t _event_count{};
 std::size_t _run_count{};
 //----------------------------------------------------------------------------------------------
 
+//__Run Wall-Clock and CPU Start________________________________________________________________
+std::chrono::steady_clock::time_point _run_start;
+std::clock_t _cpu_start{};
+//----------------------------------------------------------------------------------------------
+
 //__Mutex for ROOT Interface____________________________________________________________________
 G4Mutex _mutex = G4MUTEX_INITIALIZER;
 //----------------------------------------------------------------------------------------------
@@ -115,9 +131,13 @@ void RunAction::BeginOfRunAction(const G4Run* run) {
       _prefix = _make_directories(_data_dir) + "/run";
     _path = _prefix + std::to_string(_run_count) + ".root";
     _event_count = run->GetNumberOfEventToBeProcessed();
+    _run_start = std::chrono::steady_clock::now();
+    _cpu_start = std::clock();
   }
   lock.unlock();
 
+  Biasing::ApplyImportances();
+
   Analysis::ROOT::Setup();
   Analysis::ROOT::Open(_prefix + _temp_path);
   Analysis::ROOT::CreateNTuple(
@@ -175,6 +195,35 @@ void RunAction::EndOfRunAction(const G4Run*) {
       _write_entry(file, "EVENTS", _event_count);
       _write_entry(file, "TIMESTAMP", util::time::GetString("%c %Z"));
 
+      const std::chrono::duration<double> runtime = std::chrono::steady_clock::now() - _run_start;
+      _write_entry(file, "RUNTIME", runtime.count());
+      _write_entry(file, "EVENT_RATE", _event_count / std::max(runtime.count(), 1e-9));
+      const auto cpu_time = static_cast<double>(std::clock() - _cpu_start) / CLOCKS_PER_SEC;
+      _write_entry(file, "CPU_TIME", cpu_time);
+      _write_entry(file, "STACK_KILLED", StackingAction::KilledCount());
+      _write_entry(file, "STACK_DEFERRED", StackingAction::DeferredCount());
+      _write_entry(file, "EVENTS_ABORTED", StackingAction::AbortedCount());
+      StackingAction::ResetCounters();
+      if (MuonTransport::IsEnabled()) {
+        _write_entry(file, "MUON_TRANSPORTED", MuonTransport::TransportedCount());
+        _write_entry(file, "MUON_STOPPED", MuonTransport::StoppedCount());
+        MuonTransport::ResetCounters();
+      }
+      if (EMShower::IsEnabled()) {
+        _write_entry(file, "EM_SHOWERS_PARAMETERISED", EMShower::ShowerCount());
+        _write_entry(file, "EM_SHOWER_ENERGY", EMShower::ShowerEnergy() / GeV);
+        EMShower::ResetCounters();
+      }
+
+      Scoring::Save(file);
+      MuonTransport::Save(file);
+      EMShower::Save(file);
+      Biasing::Save(file);
+      TrackCuts::Save(file, cpu_time);
+      PhysicsCache::Save(file);
+      Acceptance::Save(file);
+      MuonMapper::SaveMap(file, _prefix + std::to_string(_run_count) + ".map");
+
       file->Close();
 
       ++_run_count;
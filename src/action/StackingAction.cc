@@ -0,0 +1,345 @@
+/*
+ * src/action/StackingAction.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "action.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include <G4EventManager.hh>
+#include <G4HCofThisEvent.hh>
+#include <G4ParticleTable.hh>
+#include <G4RunManager.hh>
+#include <G4StackManager.hh>
+#include <G4UnitsTable.hh>
+#include <tls.hh>
+
+#include "geometry/Construction.hh"
+#include "util/string.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Stacking Counters___________________________________________________________________________
+std::atomic<std::size_t> _killed_count{};
+std::atomic<std::size_t> _deferred_count{};
+std::atomic<std::size_t> _aborted_count{};
+//----------------------------------------------------------------------------------------------
+
+//__Stacking Action of the Current Thread_______________________________________________________
+G4ThreadLocal StackingAction* _instance = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Envelope Lookup State_______________________________________________________________________
+enum _envelope_status { _envelope_unloaded, _envelope_loaded, _envelope_missing };
+//----------------------------------------------------------------------------------------------
+
+//__Check if Current Event has Recorded Hits____________________________________________________
+bool _event_has_hits() {
+  const auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const auto collections = event ? event->GetHCofThisEvent() : nullptr;
+  if (!collections)
+    return false;
+  for (int i{}; i < collections->GetNumberOfCollections(); ++i) {
+    const auto collection = collections->GetHC(i);
+    if (collection && collection->GetSize())
+      return true;
+  }
+  return false;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Parse Value with Unit from Tokens___________________________________________________________
+double _parse_with_unit(const std::string& value,
+                        const std::string& unit) {
+  return std::stod(value) * G4UIcommand::ValueOf(unit.c_str());
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Stacking Action Messenger Directory Path____________________________________________________
+const std::string StackingAction::MessengerDirectory = "/stack/";
+//----------------------------------------------------------------------------------------------
+
+//__Stacking Action Constructor_________________________________________________________________
+StackingAction::StackingAction()
+    : G4UserStackingAction(),
+      G4UImessenger(MessengerDirectory, "Secondary Track Stacking."),
+      _defer(false),
+      _abort_enabled(false),
+      _abort_min_energy(0.0),
+      _envelope_state(_envelope_unloaded),
+      _envelope_geometry(0UL),
+      _stage(0UL) {
+
+  _rule = CreateCommand<Command::StringArg>("rule",
+    "Low-Value Secondary Rule: <particle> <min_ke> <unit> [<max_distance> <unit>].");
+  _rule->SetParameterName("rule", false);
+  _rule->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _clear = CreateCommand<Command::NoArg>("clear", "Remove All Stacking Rules.");
+  _clear->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _mode = CreateCommand<Command::StringArg>("mode",
+    "Kill Low-Value Secondaries or Defer them until the Detector is Hit.");
+  _mode->SetParameterName("mode", false);
+  _mode->SetCandidates("kill wait");
+  _mode->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _envelope = CreateCommand<Command::StringArg>("envelope",
+    "Volume Used as Detector Envelope for Distance Test (Trailing * Matches Prefix).");
+  _envelope->SetParameterName("volume", false);
+  _envelope->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _abort = CreateCommand<Command::BoolArg>("abort",
+    "Abort Events without Hits once no Remaining Track can Reach the Envelope.");
+  _abort->SetParameterName("abort", false);
+  _abort->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _abort_energy = CreateCommand<Command::DoubleUnitArg>("abort_energy",
+    "Set Minimum Kinetic Energy for a Track to Reach the Envelope.");
+  _abort_energy->SetParameterName("abort_energy", false, false);
+  _abort_energy->SetRange("abort_energy >= 0");
+  _abort_energy->SetDefaultUnit("MeV");
+  _abort_energy->SetUnitCandidates("keV MeV GeV");
+  _abort_energy->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Stacking Rules.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _instance = this;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Classify New Track__________________________________________________________________________
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track) {
+  const auto classification = _classify(track);
+  if (_abort_enabled && classification != fKill && _reachable(track))
+    _reachable_tracks.insert(track->GetTrackID());
+  return classification;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Abort Event if no Remaining Track can Reach the Envelope____________________________________
+void StackingAction::TrackFinished(const G4Track* track,
+                                   const G4TrackVector* secondaries) {
+  const auto action = _instance;
+  if (!action || !action->_abort_enabled)
+    return;
+
+  action->_reachable_tracks.erase(track->GetTrackID());
+  if (!action->_reachable_tracks.empty() || _event_has_hits())
+    return;
+
+  // secondaries of the finished track are only classified after this call
+  if (secondaries)
+    for (const auto secondary : *secondaries)
+      if (action->_reachable(secondary))
+        return;
+
+  ++_aborted_count;
+  G4RunManager::GetRunManager()->AbortEvent();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Apply Stacking Rules to New Track___________________________________________________________
+G4ClassificationOfNewTrack StackingAction::_classify(const G4Track* track) {
+  if (_rules.empty() || track->GetParentID() == 0 || _stage)
+    return fUrgent;
+
+  const auto search = _rules.find(track->GetParticleDefinition());
+  if (search == _rules.cend())
+    return fUrgent;
+
+  const auto& rule = search->second;
+  // with a distance, a secondary is only low-value if it is both soft and far from the envelope,
+  // so soft secondaries created in or near the detector keep their deposits
+  auto low_value = track->GetKineticEnergy() < rule.min_energy;
+  if (low_value && rule.max_distance > 0)
+    low_value = _load_envelope()
+             && _distance_to_envelope(track->GetPosition()) > rule.max_distance;
+
+  if (!low_value)
+    return fUrgent;
+
+  if (_defer) {
+    ++_deferred_count;
+    return fWaiting;
+  }
+  ++_killed_count;
+  return fKill;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Start New Stacking Stage____________________________________________________________________
+void StackingAction::NewStage() {
+  if (!_stage++ && _defer && !_event_has_hits())
+    stackManager->clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Prepare for New Event_______________________________________________________________________
+void StackingAction::PrepareNewEvent() {
+  _stage = 0UL;
+  _reachable_tracks.clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stacking Action Messenger Set Value_________________________________________________________
+void StackingAction::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _rule) {
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ");
+    tokens.erase(std::remove(tokens.begin(), tokens.end(), ""), tokens.end());
+    if (tokens.size() != 3UL && tokens.size() != 5UL) {
+      std::cout << "[Stacking] Expected: <particle> <min_ke> <unit> [<max_distance> <unit>]\n";
+      return;
+    }
+    const auto particle = G4ParticleTable::GetParticleTable()->FindParticle(tokens[0]);
+    if (!particle) {
+      std::cout << "[Stacking] Unknown Particle \"" << tokens[0] << "\".\n";
+      return;
+    }
+    try {
+      _rules[particle] = Rule{_parse_with_unit(tokens[1], tokens[2]),
+                              tokens.size() == 5UL ? _parse_with_unit(tokens[3], tokens[4]) : 0.0};
+    } catch (...) {
+      std::cout << "[Stacking] Invalid Rule \"" << value << "\".\n";
+    }
+  } else if (command == _clear) {
+    _rules.clear();
+  } else if (command == _mode) {
+    _defer = value == "wait";
+  } else if (command == _envelope) {
+    _envelope_name = value;
+    _envelope_state = _envelope_unloaded;
+  } else if (command == _abort) {
+    _abort_enabled = _abort->GetNewBoolValue(value);
+  } else if (command == _abort_energy) {
+    _abort_min_energy = _abort_energy->GetNewDoubleValue(value);
+  } else if (command == _print) {
+    std::cout << "Stacking Mode: " << (_defer ? "wait" : "kill")
+              << " | Envelope: " << (_envelope_name.empty() ? Construction::Builder::GetDetectorName()
+                                                           : _envelope_name) << "\n";
+    if (_abort_enabled)
+      std::cout << "  abort early | min ke: " << G4BestUnit(_abort_min_energy, "Energy") << "\n";
+    for (const auto& entry : _rules) {
+      std::cout << "  " << entry.first->GetParticleName()
+                << " | min ke: " << G4BestUnit(entry.second.min_energy, "Energy");
+      if (entry.second.max_distance > 0)
+        std::cout << " | max distance: " << G4BestUnit(entry.second.max_distance, "Length");
+      std::cout << "\n";
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load Detector Envelope Bounding Box_________________________________________________________
+// the envelope is reloaded whenever the geometry is rebuilt, as after /det/select, and
+// defaults to the detector selected at that time
+bool StackingAction::_load_envelope() {
+  const auto geometry = Construction::Builder::GetGeometryVersion();
+  if (_envelope_geometry != geometry) {
+    _envelope_geometry = geometry;
+    _envelope_state = _envelope_unloaded;
+  }
+  if (_envelope_state == _envelope_unloaded) {
+    const auto& name = _envelope_name.empty() ? Construction::Builder::GetDetectorName() : _envelope_name;
+    _envelope_state = Construction::GlobalExtent(name, _envelope_min, _envelope_max)
+                    ? _envelope_loaded : _envelope_missing;
+    if (_envelope_state == _envelope_missing)
+      std::cout << "[Stacking] Envelope \"" << name << "\" Not Found. "
+                << "Rules with a Distance Keep All Tracks.\n";
+  }
+  return _envelope_state == _envelope_loaded;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Distance from Point to Detector Envelope____________________________________________________
+double StackingAction::_distance_to_envelope(const G4ThreeVector& position) const {
+  const G4ThreeVector outside(
+    std::max({_envelope_min.x() - position.x(), 0.0, position.x() - _envelope_max.x()}),
+    std::max({_envelope_min.y() - position.y(), 0.0, position.y() - _envelope_max.y()}),
+    std::max({_envelope_min.z() - position.z(), 0.0, position.z() - _envelope_max.z()}));
+  return outside.mag();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Track can Reach the Detector Envelope______________________________________________
+bool StackingAction::_reachable(const G4Track* track) {
+  if (track->GetKineticEnergy() < _abort_min_energy)
+    return false;
+  return !_load_envelope()
+      || _heads_into_envelope(track->GetPosition(), track->GetMomentumDirection());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Straight Line from Point Intersects Detector Envelope______________________________
+bool StackingAction::_heads_into_envelope(const G4ThreeVector& position,
+                                          const G4ThreeVector& direction) const {
+  auto near = 0.0;
+  auto far = std::numeric_limits<double>::infinity();
+  for (int i{}; i < 3; ++i) {
+    if (direction[i] == 0.0) {
+      if (position[i] < _envelope_min[i] || position[i] > _envelope_max[i])
+        return false;
+      continue;
+    }
+    auto t0 = (_envelope_min[i] - position[i]) / direction[i];
+    auto t1 = (_envelope_max[i] - position[i]) / direction[i];
+    if (t0 > t1)
+      std::swap(t0, t1);
+    near = std::max(near, t0);
+    far = std::min(far, t1);
+    if (near > far)
+      return false;
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Number of Killed Secondaries____________________________________________________________
+std::size_t StackingAction::KilledCount() {
+  return _killed_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Number of Deferred Secondaries__________________________________________________________
+std::size_t StackingAction::DeferredCount() {
+  return _deferred_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Number of Aborted Events________________________________________________________________
+std::size_t StackingAction::AbortedCount() {
+  return _aborted_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Stacking Counters_____________________________________________________________________
+void StackingAction::ResetCounters() {
+  _killed_count = 0UL;
+  _deferred_count = 0UL;
+  _aborted_count = 0UL;
+}
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace MATHUSLA::MU */
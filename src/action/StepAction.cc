@@ -4,6 +4,8 @@
 #include "TROOT.h"
 #include "TTree.h"
 #include "TFile.h"
+
+#include "physics/MuonTransport.hh"
 namespace MATHUSLA { namespace MU {
 
 
@@ -48,7 +50,10 @@ StepAction::StepAction() : G4UserSteppingAction() {
 //----------------------------------------------------------------------------------------------
 
 void StepAction::UserSteppingAction( const G4Step* step){
-  
+  MuonTransport::Observe(step);
+  if (!ActionInitialization::Debug)
+    return;
+
 
   const auto step_point = step->GetPreStepPoint();
   const auto post_step_point = step->GetPostStepPoint();
@@ -32,7 +32,9 @@
 
 #include "action.hh"
 #include "MuonDataController.hh"
+#include "physics/Biasing.hh"
 #include "G4RunManager.hh"
+#include "G4TrackingManager.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 
@@ -42,8 +44,8 @@ namespace MATHUSLA { namespace MU {
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 TrackingAction::TrackingAction()
-:G4UserTrackingAction()
- 
+:G4UserTrackingAction(),
+ fInitialWeight(1.)
 { 
 }
 
@@ -58,12 +60,23 @@ TrackingAction::~TrackingAction()
 
 void TrackingAction::PreUserTrackingAction(const G4Track* track)
 {
+  fInitialWeight = track->GetWeight();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void TrackingAction::PostUserTrackingAction(const G4Track* track)
 {
+// The event weight is the product of the weight changes of all tracks, which is the
+// biasing weight of the whole event history (1 without biasing). Splitting and roulette
+// from importance sampling only change per-track weights, which are kept in the hits.
+if (fInitialWeight > 0. && track->GetWeight() != fInitialWeight
+    && !Biasing::IsImportanceSampled(track->GetParticleDefinition()->GetParticleName()))
+  EventAction::ScaleWeight(track->GetWeight() / fInitialWeight);
+
+// Early event abort (/stack/abort) once no remaining track can reach the detector
+StackingAction::TrackFinished(track, fpTrackingManager->GimmeSecondaries());
+
 MuonDataController* controller = MuonDataController::getMuonDataController();
 if(!(controller->getOn())){return;}
 
@@ -79,25 +92,8 @@ if(!(controller->getOn())){return;}
    if(nbtrkCurrent !=3){return;}   
  
 
-   auto CurrentPosition = track->GetPosition();
-   double Z_Value = CurrentPosition.getX();
-   double X_Value = CurrentPosition.getY();
-   double Y_Value =-(CurrentPosition.getZ())+80*m;
-   
-
-   //Definitions for zone in which decay must occur to be saved
-   G4double zmin = 70.0*m;
-   G4double zmax = 170*m;
-   G4double xmin = -49.5*m;
-   G4double xmax = 49.5*m;
-   G4double ymin = 60.03*m;
-   //this is the bottom of the third scintilator from the top of the detector
-   G4double ymaxZone = 87.095*m;  
-
- 
-   if( (xmin<X_Value) && (X_Value<xmax) 
-    && (ymin<Y_Value) && (Y_Value<ymaxZone)
-    && (zmin<Z_Value) && (Z_Value<zmax)){
+   //Decay zone is configured through /bias/decay/ (physics/Biasing.hh)
+   if(Biasing::InDecayZone(track->GetPosition())){
     controller->setDecayInZone(true);
    G4cout<<"Set decay in zone true"<<G4endl;
     }   
@@ -0,0 +1,21 @@
+#include "physics/FileReaderGenerator.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+int main(const int argc, const char *const argv[]) {
+  if (argc != 3) {
+    std::cout << "Usage: " << argv[0] << " <input> <output>" << std::endl;
+    std::cout << "Converts a file_reader particle parameters file to the binary format." << std::endl;
+    return 1;
+  }
+  try {
+    const auto events = MATHUSLA::MU::Physics::ConvertParticleFile(argv[1], argv[2]);
+    std::cout << "Wrote " << events << " events to " << argv[2] << std::endl;
+  } catch (const std::exception &error) {
+    std::cerr << argv[0] << ": " << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
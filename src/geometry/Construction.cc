@@ -1,6 +1,9 @@
 
 #include "geometry/Construction.hh"
 
+#include <atomic>
+#include <limits>
+
 #include <G4SubtractionSolid.hh>
 #include <G4GeometryManager.hh>
 #include <G4GeometryTolerance.hh>
@@ -12,6 +15,8 @@
 #include <G4PVPlacement.hh>
 #include <G4NistManager.hh>
 #include <G4GDMLParser.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
 #include <tls.hh>
 
 #include "geometry/Box.hh"
@@ -20,7 +25,9 @@
 #include "geometry/Flat.hh"
 #include "geometry/MuonMapper.hh"
 
-#include "MultiParticleChangeCrossSection.hh"
+#include "physics/Biasing.hh"
+#include "physics/MuonTransport.hh"
+#include "physics/EMShower.hh"
 
 #include "util/io.hh"
 
@@ -41,12 +48,43 @@ const Analysis::ROOT::DataKeyList* _data_keys;
 const Analysis::ROOT::DataKeyTypeList* _data_key_types;
 bool _save_option;
 bool _cut_save_option;
+std::atomic<std::size_t> _geometry_version{0UL};
 //----------------------------------------------------------------------------------------------
 
 //__Detector List_______________________________________________________________________________
 const std::string& _detectors = "Prototype Flat Cosmic Box MuonMapper";
 //----------------------------------------------------------------------------------------------
 
+//__Extend Bounding Box by Volume and Matching Daughters________________________________________
+void _extend_bounds(const G4VPhysicalVolume* volume,
+                    const G4Transform3D& frame,
+                    const std::string& name,
+                    const bool prefix,
+                    G4ThreeVector& min,
+                    G4ThreeVector& max) {
+  const auto local = frame * G4Transform3D(volume->GetObjectRotationValue(),
+                                           volume->GetObjectTranslation());
+  const std::string volume_name = volume->GetName();
+  const auto logical = volume->GetLogicalVolume();
+
+  if (prefix ? volume_name.rfind(name, 0) == 0 : volume_name == name) {
+    G4ThreeVector local_min, local_max;
+    logical->GetSolid()->BoundingLimits(local_min, local_max);
+    for (std::size_t corner{}; corner < 8UL; ++corner) {
+      const auto point = local * G4Point3D(corner & 1UL ? local_max.x() : local_min.x(),
+                                           corner & 2UL ? local_max.y() : local_min.y(),
+                                           corner & 4UL ? local_max.z() : local_min.z());
+      min.set(std::min(min.x(), point.x()), std::min(min.y(), point.y()), std::min(min.z(), point.z()));
+      max.set(std::max(max.x(), point.x()), std::max(max.y(), point.y()), std::max(max.z(), point.z()));
+    }
+    return;
+  }
+
+  for (std::size_t i{}; i < logical->GetNoDaughters(); ++i)
+    _extend_bounds(logical->GetDaughter(i), local, name, prefix, min, max);
+}
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 namespace Construction { ///////////////////////////////////////////////////////////////////////
@@ -98,12 +136,17 @@ Builder::Builder(const std::string& detector,
 
   _current = CreateCommand<Command::NoArg>("current", "Current Detector.");
   _current->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _readout = new Box::Readout;
+  _regions = new Regions;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Build World and Detector Geometry___________________________________________________________
 G4VPhysicalVolume* Builder::Construct() {
+  ++_geometry_version;
   G4GeometryManager::GetInstance()->OpenGeometry();
+  Regions::Clear();
   G4PhysicalVolumeStore::GetInstance()->Clean();
   G4LogicalVolumeStore::GetInstance()->Clean();
   G4SolidStore::GetInstance()->Clean();
@@ -206,14 +249,7 @@ void Builder::ConstructSDandField() {
     _data_key_types = &Cosmic::Detector::DataKeyTypes;
     G4SDManager::GetSDMpointer()->AddNewDetector(new Cosmic::Detector);
 
-    G4LogicalVolume* earth_volume = G4LogicalVolumeStore::GetInstance()->GetVolume("ModifiedSandstoneCosmic");
-    MultiParticleChangeCrossSection* biasingOperator = new MultiParticleChangeCrossSection;
-    biasingOperator->AddParticle( "mu+" );
-    biasingOperator->AddParticle( "mu-" );
-    biasingOperator->AttachTo(earth_volume);
-    G4cout << " Attaching biasing operator " << biasingOperator->GetName()
-           << " to logical volume " << earth_volume->GetName()
-           << G4endl;
+    Biasing::Attach("ModifiedSandstoneCosmic");
   } else if (_detector == "Box") {
     _data_per_event = Box::Detector::DataPerEvent;
     _data_name = Box::Detector::DataName;
@@ -221,14 +257,7 @@ void Builder::ConstructSDandField() {
     _data_key_types = &Box::Detector::DataKeyTypes;
     G4SDManager::GetSDMpointer()->AddNewDetector(new Box::Detector);
 
-    G4LogicalVolume* earth_volume = G4LogicalVolumeStore::GetInstance()->GetVolume("ModifiedSandstone");
-    MultiParticleChangeCrossSection* biasingOperator = new MultiParticleChangeCrossSection;
-    biasingOperator->AddParticle( "mu+" );
-    biasingOperator->AddParticle( "mu-" );
-    biasingOperator->AttachTo(earth_volume);
-    G4cout << " Attaching biasing operator " << biasingOperator->GetName()
-           << " to logical volume " << earth_volume->GetName()
-           << G4endl;
+    Biasing::Attach("ModifiedSandstone");
   } else if (_detector == "MuonMapper") {
     _data_per_event = MuonMapper::Detector::DataPerEvent;
     _data_name = MuonMapper::Detector::DataName;
@@ -242,6 +271,10 @@ void Builder::ConstructSDandField() {
     _data_key_types = &Prototype::Detector::DataKeyTypes;
     G4SDManager::GetSDMpointer()->AddNewDetector(new Prototype::Detector);
   }
+
+  Biasing::AttachForcedDecay();
+  MuonTransport::Attach();
+  EMShower::Attach();
 }
 //----------------------------------------------------------------------------------------------
 
@@ -299,6 +332,12 @@ const std::string& Builder::GetDetectorName() {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Get Number of Times the Geometry was Built__________________________________________________
+std::size_t Builder::GetGeometryVersion() {
+  return _geometry_version;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Get Current Detector Data Preference________________________________________________________
 bool Builder::IsDetectorDataPerEvent() {
   return _data_per_event;
@@ -628,6 +667,25 @@ G4RotationMatrix Matrix(const double mxx,
 }
 //----------------------------------------------------------------------------------------------
 
+//__World Bounding Box of Named Volumes (Trailing * Matches Prefix)____________________________
+bool GlobalExtent(const std::string& name,
+                  G4ThreeVector& min,
+                  G4ThreeVector& max) {
+  const auto world = G4TransportationManager::GetTransportationManager()
+                       ->GetNavigatorForTracking()->GetWorldVolume();
+  if (!world || name.empty())
+    return false;
+
+  const auto prefix = name.back() == '*';
+  constexpr auto infinity = std::numeric_limits<double>::infinity();
+  min.set(infinity, infinity, infinity);
+  max.set(-infinity, -infinity, -infinity);
+  _extend_bounds(world, G4Transform3D::Identity, prefix ? name.substr(0, name.size() - 1) : name,
+                 prefix, min, max);
+  return min.x() <= max.x();
+}
+//----------------------------------------------------------------------------------------------
+
 //__GDML File Export____________________________________________________________________________
 void Export(const G4LogicalVolume* volume,
             const std::string& dir,
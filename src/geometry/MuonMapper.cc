@@ -1,12 +1,23 @@
 #include "geometry/MuonMapper.hh"
 
+#include <algorithm>
+#include <fstream>
+
+#include <G4AutoLock.hh>
+#include <G4EventManager.hh>
+#include <G4Navigator.hh>
 #include <G4NistManager.hh>
+#include <G4TransportationManager.hh>
 #include <G4VProcess.hh>
 #include <tls.hh>
 
+#include <TFile.h>
+#include <TH1D.h>
+
 #include "action.hh"
 #include "analysis.hh"
 #include "geometry/Earth.hh"
+#include "physics/Generator.hh"
 
 namespace MATHUSLA { namespace MU {
 
@@ -16,6 +27,107 @@ namespace { ////////////////////////////////////////////////////////////////////
 //__MuonMapper Sensitive Material_______________________________________________________________
 G4LogicalVolume* _box;
 //----------------------------------------------------------------------------------------------
+
+//__Transfer Map Accumulation per Grid Point____________________________________________________
+struct _map_point {
+  double energy, angle, path, column;
+  std::size_t generated, survived;
+  TH1D* loss;
+  TH1D* deflection;
+};
+std::vector<_map_point> _map;
+G4Mutex _map_mutex = G4MUTEX_INITIALIZER;
+constexpr std::size_t _map_quantiles = 11UL;
+//----------------------------------------------------------------------------------------------
+
+//__Column Density along Straight Line to the Stopper___________________________________________
+// the map is keyed on column density rather than path length, so it can be applied to paths
+// through rock layers of any density
+double _column_density(const G4ThreeVector& position,
+                       const G4ThreeVector& direction) {
+  G4Navigator navigator;
+  navigator.SetWorldVolume(
+    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+  auto point = position;
+  auto volume = navigator.LocateGlobalPointAndSetup(point, &direction, false, false);
+  double column{};
+  for (std::size_t i{}; i < 1000UL && volume && volume->GetLogicalVolume() != _box; ++i) {
+    G4double safety;
+    const auto length = navigator.ComputeStep(point, direction, kInfinity, safety);
+    if (length == kInfinity)
+      break;
+    column += volume->GetLogicalVolume()->GetMaterial()->GetDensity() * length;
+    point += length * direction;
+    navigator.SetGeometricallyLimitedStep();
+    volume = navigator.LocateGlobalPointAndSetup(point, &direction, true);
+  }
+  return column;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Clear Transfer Map__________________________________________________________________________
+void _clear_map() {
+  for (auto& point : _map) {
+    delete point.loss;
+    delete point.deflection;
+  }
+  _map.clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Record Event in Transfer Map________________________________________________________________
+void _record(const Physics::MapGenerator& generator,
+             const G4Event& event,
+             const bool survived,
+             const double exit_energy,
+             const G4ThreeVector& exit_direction) {
+  const auto index = generator.point(event.GetEventID());
+  G4AutoLock lock(&_map_mutex);
+  if (_map.size() != generator.size()) {
+    _clear_map();
+    for (std::size_t i{}; i < generator.size(); ++i) {
+      const auto tag = "muon_map_" + std::to_string(i);
+      const auto title = std::to_string(generator.energy(i) / GeV) + " GeV at "
+                       + std::to_string(generator.angle(i) / deg) + " deg";
+      _map.push_back({generator.energy(i), generator.angle(i), generator.path(i), -1.0, 0UL, 0UL,
+        new TH1D((tag + "_loss").c_str(), (title + ";#DeltaE / E;muons").c_str(), 200, 0, 1),
+        new TH1D((tag + "_deflection").c_str(), (title + ";#theta [mrad];muons").c_str(), 500, 0, 500)});
+      _map.back().loss->SetDirectory(nullptr);
+      _map.back().deflection->SetDirectory(nullptr);
+    }
+  }
+
+  auto& point = _map[index];
+  if (point.column < 0) {
+    const auto vertex = event.GetPrimaryVertex();
+    const auto primary = vertex ? vertex->GetPrimary() : nullptr;
+    point.column = primary ? _column_density(vertex->GetPosition(), primary->GetMomentumDirection()) : 0.0;
+  }
+  ++point.generated;
+  if (!survived)
+    return;
+  ++point.survived;
+  const G4ThreeVector initial(std::sin(point.angle), 0, -std::cos(point.angle));
+  point.loss->Fill(1.0 - exit_energy / point.energy);
+  point.deflection->Fill(initial.angle(exit_direction) / mrad);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Quantiles of Histogram________________________________________________________________
+void _write_quantiles(std::ofstream& file,
+                      TH1D* histogram) {
+  double probabilities[_map_quantiles], quantiles[_map_quantiles];
+  for (std::size_t i{}; i < _map_quantiles; ++i) {
+    probabilities[i] = i / (_map_quantiles - 1.0);
+    quantiles[i] = 0;
+  }
+  if (histogram->GetEntries())
+    histogram->GetQuantiles(_map_quantiles, quantiles, probabilities);
+  for (std::size_t i{}; i < _map_quantiles; ++i)
+    file << ' ' << quantiles[i];
+}
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 namespace Material { ///////////////////////////////////////////////////////////////////////////
@@ -39,37 +151,36 @@ Detector::Detector() : G4VSensitiveDetector("MATHUSLA/MU/MuonMapper") {
 //----------------------------------------------------------------------------------------------
 
 //__Initalize Event_____________________________________________________________________________
-void Detector::Initialize(G4HCofThisEvent*) {}
+void Detector::Initialize(G4HCofThisEvent*) {
+  _survived = false;
+  _exit_energy = 0;
+}
 //----------------------------------------------------------------------------------------------
 
 //__Hit Processing______________________________________________________________________________
 G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
   const auto pre_step = step->GetPreStepPoint();
   const auto track = step->GetTrack();
-  try {
-    if (track->GetParticleDefinition()->GetParticleName() != "mu-")
-      return false;
-
-    constexpr auto mass = 105.658369L;
-    const auto process = pre_step->GetProcessDefinedStep();
-    const auto process_name = process->GetProcessName();
-    if (process_name == "Transportation" && track->GetVolume() == track->GetNextVolume()) {
-      const auto kinetic = track->GetKineticEnergy() / MeV; // from GeV correction
-      /*
-      Analysis::ROOT::FillNTuple(DataPrefix, 0, {
-        (track->GetPosition() - G4ThreeVector(0, 0, 100*m)).mag() / m,
-        static_cast<double>(std::log10(std::sqrt(kinetic*kinetic + 2*kinetic*mass) / mass))});
-      */
-      track->SetTrackStatus(fStopAndKill);
-      return true;
-    }
-  } catch (...) {}
-  return false;
+  if (track->GetParentID() != 0
+      || std::abs(track->GetParticleDefinition()->GetPDGEncoding()) != 13
+      || pre_step->GetStepStatus() != fGeomBoundary)
+    return false;
+
+  _survived = true;
+  _exit_energy = pre_step->GetKineticEnergy();
+  _exit_direction = pre_step->GetMomentumDirection();
+  track->SetTrackStatus(fStopAndKill);
+  return true;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Post-Event Processing_______________________________________________________________________
-void Detector::EndOfEvent(G4HCofThisEvent*) {}
+void Detector::EndOfEvent(G4HCofThisEvent*) {
+  const auto generator = dynamic_cast<const Physics::MapGenerator*>(GeneratorAction::GetGenerator());
+  const auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  if (generator && generator->size() && event)
+    _record(*generator, *event, _survived, _exit_energy, _exit_direction);
+}
 //----------------------------------------------------------------------------------------------
 
 //__Build Detector______________________________________________________________________________
@@ -95,6 +206,38 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Write Muon Transfer Map Histograms and Lookup Table_________________________________________
+void SaveMap(TFile* file,
+             const std::string& path) {
+  G4AutoLock lock(&_map_mutex);
+  if (_map.empty())
+    return;
+
+  if (file) {
+    file->cd();
+    for (const auto& point : _map) {
+      point.loss->Write();
+      point.deflection->Write();
+    }
+  }
+
+  std::ofstream table(path);
+  table << "# MATHUSLA MU-SIM MUON MAP\n"
+        << "# version 2\n"
+        << "# quantiles " << _map_quantiles << "\n"
+        << "# energy[GeV] angle[rad] path[m] column[g/cm2] generated survived loss_quantiles[dE/E] deflection_quantiles[mrad]\n";
+  for (const auto& point : _map) {
+    table << point.energy / GeV << ' ' << point.angle / rad << ' ' << point.path / m << ' '
+          << std::max(point.column, 0.0) / (g/cm2) << ' ' << point.generated << ' ' << point.survived;
+    _write_quantiles(table, point.loss);
+    _write_quantiles(table, point.deflection);
+    table << '\n';
+  }
+  std::cout << "Muon Map: " << path << "\n";
+  _clear_map();
+}
+//----------------------------------------------------------------------------------------------
+
 } /* namespace MuonMapper */ ///////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
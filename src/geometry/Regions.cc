@@ -0,0 +1,194 @@
+/*
+ * src/geometry/Regions.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry/Construction.hh"
+
+#include <G4Region.hh>
+#include <G4RegionStore.hh>
+#include <G4ProductionCuts.hh>
+#include <G4UserLimits.hh>
+#include <G4UnitsTable.hh>
+#include <tls.hh>
+
+namespace MATHUSLA { namespace MU {
+
+namespace Construction { ///////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Region Settings_____________________________________________________________________________
+struct _region_setting {
+  std::string name, directory;
+  double cut, step;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Configurable Regions (Unset Values Use Global Defaults)_____________________________________
+std::vector<_region_setting> _settings{
+  {"Scintillator", "scintillator", -1, -1},
+  {"Steel",        "steel",        -1, -1},
+  {"Concrete",     "concrete",     -1, -1},
+  {"Earth",        "earth",        -1, -1}};
+//----------------------------------------------------------------------------------------------
+
+//__Find Region Setting Index___________________________________________________________________
+std::size_t _find_setting(const std::string& name) {
+  for (std::size_t i{}; i < _settings.size(); ++i)
+    if (_settings[i].name == name)
+      return i;
+  return _settings.size();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Geant4 Region if Built__________________________________________________________________
+G4Region* _get_region(const std::string& name) {
+  return G4RegionStore::GetInstance()->GetRegion(name, false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Apply Stored Setting to Geant4 Region_______________________________________________________
+void _apply(const _region_setting& setting) {
+  auto region = _get_region(setting.name);
+  if (!region)
+    return;
+
+  if (setting.cut > 0) {
+    auto cuts = region->GetProductionCuts();
+    const auto default_region = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+    if (!cuts || (default_region && cuts == default_region->GetProductionCuts())) {
+      cuts = new G4ProductionCuts;
+      region->SetProductionCuts(cuts);
+    }
+    cuts->SetProductionCut(setting.cut);
+  }
+
+  if (setting.step > 0) {
+    auto limits = region->GetUserLimits();
+    if (limits) {
+      limits->SetMaxAllowedStep(setting.step);
+    } else {
+      region->SetUserLimits(new G4UserLimits(setting.step));
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Regions Messenger Directory Path____________________________________________________________
+const std::string Regions::MessengerDirectory = "/det/region/";
+//----------------------------------------------------------------------------------------------
+
+//__Regions Constructor_________________________________________________________________________
+Regions::Regions() : G4UImessenger(MessengerDirectory, "Production Cut and Step Limit Regions.") {
+  for (const auto& setting : _settings) {
+    auto cut = CreateCommand<Command::DoubleUnitArg>(setting.directory + "/cut",
+      "Set Production Cut in " + setting.name + " Region.");
+    cut->SetParameterName("cut", false, false);
+    cut->SetRange("cut > 0");
+    cut->SetDefaultUnit("mm");
+    cut->SetUnitCandidates("um mm cm m");
+    cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+    cut->SetToBeBroadcasted(false);
+    _cut.push_back(cut);
+
+    auto step = CreateCommand<Command::DoubleUnitArg>(setting.directory + "/step",
+      "Set Maximum Step Length in " + setting.name + " Region.");
+    step->SetParameterName("step", false, false);
+    step->SetRange("step > 0");
+    step->SetDefaultUnit("m");
+    step->SetUnitCandidates("mm cm m");
+    step->AvailableForStates(G4State_PreInit, G4State_Idle);
+    step->SetToBeBroadcasted(false);
+    _step.push_back(step);
+  }
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Region Settings.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Regions Messenger Set New Value_____________________________________________________________
+void Regions::SetNewValue(G4UIcommand* command, G4String value) {
+  for (std::size_t i{}; i < _settings.size(); ++i) {
+    if (command == _cut[i]) {
+      _settings[i].cut = _cut[i]->GetNewDoubleValue(value);
+      _apply(_settings[i]);
+      return;
+    } else if (command == _step[i]) {
+      _settings[i].step = _step[i]->GetNewDoubleValue(value);
+      _apply(_settings[i]);
+      return;
+    }
+  }
+  if (command == _print)
+    Print();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Detach All Volumes from Regions_____________________________________________________________
+void Regions::Clear() {
+  for (const auto& setting : _settings) {
+    auto region = _get_region(setting.name);
+    if (!region)
+      continue;
+    std::vector<G4LogicalVolume*> roots;
+    auto it = region->GetRootLogicalVolumeIterator();
+    for (std::size_t i{}; i < region->GetNumberOfRootVolumes(); ++i, ++it)
+      roots.push_back(*it);
+    for (auto& volume : roots)
+      region->RemoveRootLogicalVolume(volume);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Root Volume to Region___________________________________________________________________
+void Regions::Add(const std::string& name,
+                  G4LogicalVolume* volume) {
+  const auto index = _find_setting(name);
+  if (index == _settings.size() || !volume)
+    return;
+  auto region = _get_region(name);
+  if (!region)
+    region = new G4Region(name);
+  region->AddRootLogicalVolume(volume);
+  _apply(_settings[index]);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Region Settings_______________________________________________________________________
+std::ostream& Regions::Print(std::ostream& os) {
+  os << "Regions:\n";
+  for (const auto& setting : _settings) {
+    const auto region = _get_region(setting.name);
+    os << "  " << setting.name
+       << " | volumes: " << (region ? region->GetNumberOfRootVolumes() : 0UL)
+       << " | cut: ";
+    if (setting.cut > 0) os << G4BestUnit(setting.cut, "Length"); else os << "default";
+    os << " | step: ";
+    if (setting.step > 0) os << G4BestUnit(setting.step, "Length"); else os << "default";
+    os << "\n";
+  }
+  return os;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Construction */ /////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
@@ -320,163 +320,20 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
   const auto new_momentum = G4LorentzVector(step_point->GetTotalEnergy(), momentum_transformed);
   //__________________________________________________________________________________________
 
-  const auto local_position = new_position.vect() - G4ThreeVector(y_displacement, z_displacement, x_displacement);
-
-  // auto z_index = static_cast<size_t>(std::floor(+local_position.y() / (layer_spacing + scintillator_height)));
-  size_t y_index = 0;
-
-//  if (new_position.y() < 6050.0L*cm) {
-//    y_index = static_cast<std::size_t>(std::floor(+local_position.y() / (layer_spacing + scintillator_height)));
-//  } else if (new_position.y() > 6060.0L*cm && new_position.y() < 6150.0L*cm) {
-//    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 1.0L*cm) / (layer_spacing + scintillator_height)));
-//  } else if (new_position.y() > 7900.0L*cm && new_position.y() < 8050.0L*cm) {
-//    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 1796.0L*cm) / (layer_spacing + scintillator_height)));
-//  } else if (new_position.y() > 8050.0L*cm && new_position.y() < 8150.0L*cm) {
-//    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 1797.0L*cm) / (layer_spacing + scintillator_height)));
-//  } else if (new_position.y() > 8400.0L*cm && new_position.y() < 8550.0L*cm) {
-//    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2092.0L*cm) / (layer_spacing + scintillator_height)));
-//  } else if (new_position.y() > 8560.0L*cm && new_position.y() < 8650.0L*cm) {
-//    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2093.0L*cm) / (layer_spacing + scintillator_height)));
-// } else if (new_position.y() > 8660.0L*cm && new_position.y() < 8750.0L*cm) {
-//    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2094.0L*cm) / (layer_spacing + scintillator_height)));
-//  } else if (new_position.y() > 8760.0L*cm && new_position.y() < 8850.0L*cm) {
-//    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2095.0L*cm) / (layer_spacing + scintillator_height)));
-//  } else {
-//    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2096.0L*cm) / (layer_spacing + scintillator_height)));
- // }
-
-   if (new_position.y() <= 6003.5L*cm) {
-    y_index = static_cast<std::size_t>(std::floor(+local_position.y() / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 6103.5L*cm && new_position.y() <= 6105.5L*cm) {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 100.0L*cm) / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 8101.5L*cm && new_position.y() <= 8103.5L*cm) {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 1996.0L*cm) / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 8203.5L*cm && new_position.y() <= 8205.5L*cm) {
-    y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2096.0L*cm) / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 8601.5L*cm && new_position.y() <= 8603.5L*cm) {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2492.0L*cm) / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 8683.5L*cm && new_position.y() <= 8685.5L*cm) {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2492.0L*cm +80.0L*cm) / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 8765.5L*cm && new_position.y() <= 8767.5L*cm) {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2492.0L*cm +2*80.0L*cm) / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 8847.5L*cm && new_position.y() <= 8849.5L*cm) {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2492.0L*cm +3*80.0L*cm) / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 8929.5L*cm && new_position.y() <= 8931.5L*cm) {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2492.0L*cm +4*80.0L*cm) / (layer_spacing + scintillator_height)));
-   } else if (new_position.y() >= 9011.5L*cm && new_position.y() <= 9013.5L*cm) {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2492.0L*cm +5*80.0L*cm) / (layer_spacing + scintillator_height)));
-   } else {
-	   y_index = static_cast<std::size_t>(std::floor((+local_position.y() - 2492.0L*cm +6*80.0L*cm) / (layer_spacing + scintillator_height)));
-  }
-
-  int _rotation = (1UL + y_index) % 2;
-  size_t x_index = 0;
-  size_t z_index = 0;
-
-  if (_rotation == 0){
-
-	  if (new_position.x() <= -4050.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor(+local_position.x() / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= -3950.0L*cm && new_position.x() <= -3050.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 100.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= -2950.0L*cm && new_position.x() <= -2050.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 200.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= -1950.0L*cm && new_position.x() <= -1050.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 300.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= -950.0L*cm && new_position.x() <= -50.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 400.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= 50.0L*cm && new_position.x() <= 950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 500.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= 1050.0L*cm && new_position.x() <= 1950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 600.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= 2050.0L*cm && new_position.x() <= 2950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 700.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= 3050.0L*cm && new_position.x() <= 3950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 800.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.x() >= 4050.0L*cm && new_position.x() <= 4950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 900.0L*cm) / (scint_y_edge_length) ));
-	  }
-	  if (new_position.z() <= 7900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor(+local_position.z() / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 8000.0L*cm && new_position.z() <= 8900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 100.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 9000.0L*cm && new_position.z() <= 9900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 200.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 10000.0L*cm && new_position.z() <= 10900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 300.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 11000.0L*cm && new_position.z() <= 11900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 400.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 12000.0L*cm && new_position.z() <= 12900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 500.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 13000.0L*cm && new_position.z() <= 13900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 600.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 14000.0L*cm && new_position.z() <= 14900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 700.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 15000.0L*cm && new_position.z() <= 15900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 800.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.z() >= 16000.0L*cm && new_position.z() <= 16900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 900.0L*cm) / (scint_x_edge_length) ));
-	  }
-
-  } else if (_rotation == 1){
-
-	  if (new_position.x() <= -4050.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor(+local_position.x() / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= -3950.0L*cm && new_position.x() <= -3050.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 100.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= -2950.0L*cm && new_position.x() <= -2050.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 200.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= -1950.0L*cm && new_position.x() <= -1050.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 300.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= -950.0L*cm && new_position.x() <= -50.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 400.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= 50.0L*cm && new_position.x() <= 950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 500.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= 1050.0L*cm && new_position.x() <= 1950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 600.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= 2050.0L*cm && new_position.x() <= 2950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 700.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= 3050.0L*cm && new_position.x() <= 3950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 800.0L*cm) / (scint_x_edge_length) ));
-	  } else if (new_position.x() >= 4050.0L*cm && new_position.x() <= 4950.0L*cm) {
-		  x_index = static_cast<std::size_t>(std::floor((+local_position.x() - 900.0L*cm) / (scint_x_edge_length) ));
-	  }
-	  if (new_position.z() <= 7900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor(+local_position.z() / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 8000.0L*cm && new_position.z() <= 8900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 100.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 9000.0L*cm && new_position.z() <= 9900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 200.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 10000.0L*cm && new_position.z() <= 10900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 300.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 11000.0L*cm && new_position.z() <= 11900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 400.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 12000.0L*cm && new_position.z() <= 12900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 500.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 13000.0L*cm && new_position.z() <= 13900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 600.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 14000.0L*cm && new_position.z() <= 14900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 700.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 15000.0L*cm && new_position.z() <= 15900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 800.0L*cm) / (scint_y_edge_length) ));
-	  } else if (new_position.z() >= 16000.0L*cm && new_position.z() <= 16900.0L*cm) {
-		  z_index = static_cast<std::size_t>(std::floor((+local_position.z() - 900.0L*cm) / (scint_y_edge_length) ));
-	  }
-  }
-
-  const auto x_name = std::to_string(x_index);
-  const auto z_name = std::to_string(z_index);
+  std::string chamber;
+  if (!Readout::Locate(step, chamber))
+    return false;
 
   _hit_collection->insert(new Tracking::Hit(
     particle,
     trackID,
     parentID,
-	std::to_string(1UL + y_index)
-    + (z_index < 10UL ? "000" + z_name : (z_index < 100UL ? "00" + z_name : (z_index < 1000UL ? "0" + z_name : z_name)))
-	+ (x_index < 10UL ? "000" + x_name : (x_index < 100UL ? "00" + x_name : (x_index < 1000UL ? "0" + x_name : x_name))),
+    chamber,
     deposit / Units::Energy,
     G4LorentzVector(new_position.t() / Units::Time,   new_position.vect() / Units::Length),
-    G4LorentzVector(new_momentum.e() / Units::Energy, new_momentum.vect() / Units::Momentum)));
+    G4LorentzVector(new_momentum.e() / Units::Energy, new_momentum.vect() / Units::Momentum),
+    track->GetWeight(),
+    step->GetPreStepPoint()->GetWeight()));
 
   return true;
 }
@@ -517,6 +374,7 @@ void Detector::EndOfEvent(G4HCofThisEvent*) {
   root_data.push_back(collection_data[11]);
   root_data.push_back(collection_data[12]);
   root_data.push_back(collection_data[13]);
+  root_data.push_back(collection_data[14]);
 
   const auto gen_particle_data = Tracking::ConvertToAnalysis(GeneratorAction::GetLastEvent(), SaveAll);
   const auto extra_gen_data = Tracking::ConvertToAnalysis(GeneratorAction::GetGenerator()->ExtraDetails());
@@ -524,9 +382,10 @@ void Detector::EndOfEvent(G4HCofThisEvent*) {
   root_data.insert(root_data.cend(), extra_gen_data.cbegin(), extra_gen_data.cend());
 
   Analysis::ROOT::DataEntry metadata;
-  metadata.reserve(2UL);
+  metadata.reserve(3UL);
   metadata.push_back(collection_data[0UL].size());
   metadata.push_back(gen_particle_data[0UL].size());
+  metadata.push_back(EventAction::Weight());
 
   Analysis::ROOT::FillNTuple(DataName, Detector::DataKeyTypes, metadata, root_data);
   if (verboseLevel >= 2 && _hit_collection)
@@ -544,6 +403,9 @@ G4VPhysicalVolume* Detector::ConstructScintillatorLayer(G4LogicalVolume* ModuleV
       scintillator_casing_thickness);
 
       _scintillators.push_back(current);
+      Construction::Regions::Add("Scintillator", current->GetVolume());
+      Readout::Register(current->GetSensitiveVolume(), "L" + std::to_string(layer_number),
+                        module_number / 10, module_number % 10);
 
       UNUSED(module_x_displacement);
       UNUSED(module_y_displacement);
@@ -586,6 +448,9 @@ G4VPhysicalVolume* Detector::ConstructModule(G4LogicalVolume* DetectorVolume, in
 		auto BeamR2 = Construction::OpenBoxVolume("Module" + std::to_string(tag_number) + "BL" + std::to_string(beam_layer) + "PR2", beam_x_edge_length, beam_y_edge_length, module_beam_heights[beam_layer],
 												  beam_thickness, Construction::Material::Iron, Construction::CasingAttributes());
 
+		for (auto beam : {BeamL1, BeamL2, BeamR1, BeamR2})
+			Construction::Regions::Add("Steel", beam);
+
 		Construction::PlaceVolume(BeamL1, ModuleVolume, Construction::Transform(-0.50*module_x_edge_length + 0.50*beam_x_edge_length,
 																				-0.50*module_y_edge_length + 0.50*beam_y_edge_length,
 																				-1.0*module_beam_z_pos[beam_layer]));
@@ -620,6 +485,7 @@ G4VPhysicalVolume* Detector::ConstructModule(G4LogicalVolume* DetectorVolume, in
 G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
 	Scintillator::Material::Define();
 	_scintillators.clear();
+	Readout::Clear();
 	// pre_data->Branch("X_S", &X_POS_STEP, "X_S/D");
 	// pre_data->Branch("Y_S", &Y_POS_STEP, "Y_S/D");
 	// pre_data->Branch("X_H", &X_POS_HIT, "X_H/D");
@@ -643,6 +509,8 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
                                                  full_layer_height,
                                                  scintillator_casing_thickness);
     _scintillators.push_back(first_hermetic_floor);
+    Construction::Regions::Add("Scintillator", first_hermetic_floor->GetVolume());
+    Readout::Register(first_hermetic_floor->GetSensitiveVolume(), "HF1");
     first_hermetic_floor->PlaceIn(DetectorVolume, G4Translate3D(0.0, 0.0, half_detector_height - 0.5*layer_w_case - steel_height));
 
     auto second_hermetic_floor = new Scintillator("HF2",
@@ -651,6 +519,8 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
                                                  full_layer_height,
                                                  scintillator_casing_thickness);
     _scintillators.push_back(second_hermetic_floor);
+    Construction::Regions::Add("Scintillator", second_hermetic_floor->GetVolume());
+    Readout::Register(second_hermetic_floor->GetSensitiveVolume(), "HF2");
     second_hermetic_floor->PlaceIn(DetectorVolume, G4Translate3D(0.0, 0.0, half_detector_height - 1.5*layer_w_case - layer_spacing - steel_height));
 
  //   auto third_hermetic_floor = new Scintillator("HF3",
@@ -667,12 +537,15 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
                                             wall_height,
                                             scintillator_casing_thickness);                                                                      
     _scintillators.push_back(hermetic_wall);
+    Construction::Regions::Add("Scintillator", hermetic_wall->GetVolume());
+    Readout::Register(hermetic_wall->GetSensitiveVolume(), "HW1");
     hermetic_wall->PlaceIn(DetectorVolume, G4Translate3D(-0.5L*x_edge_length - 0.5L*full_layer_height - wall_gap, 0.0, half_detector_height -  0.5L*wall_height));
     
     _steel = Construction::BoxVolume("SteelPlate",
 			 x_edge_length, y_edge_length, steel_height,
 			 Construction::Material::Iron,
 			 Construction::CasingAttributes());
+	Construction::Regions::Add("Steel", _steel);
 	Construction::PlaceVolume(_steel, DetectorVolume, Construction::Transform(0.0, 0.0, half_detector_height - 0.5*steel_height));
 
 	//	Construction::Export(DetectorVolume, folder, file, arg4 );
@@ -831,6 +704,7 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world){
 	auto UXC_55_air_v2 = new G4SubtractionSolid("UXC_55_air_v2", UXC_55_air_v1, CMS_Detector_logical->GetSolid());
 	auto UXC55_air_logical = Volume("UXC55_air", UXC_55_air_v2, Construction::Material::Air, G4VisAttributes::GetInvisible());
 
+	Construction::Regions::Add("Concrete", UXC55_outer_logical);
 	Construction::PlaceVolume(UXC55_outer_logical, earth, Cavern_Transform()*Construction::Rotate(0, 1, 0, 90*deg) );
 	Construction::PlaceVolume(CMS_Detector_logical, earth, Cavern_Transform()*Construction::Rotate(0, 1, 0, 90*deg) );
 	Construction::PlaceVolume(UXC55_air_logical, earth, Cavern_Transform()*Construction::Rotate(0, 1, 0, 90*deg) );
@@ -855,6 +729,7 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world){
 									  Construction::Material::Air,
 									  G4VisAttributes::GetInvisible());
 
+	Construction::Regions::Add("Concrete", Access_Shaft_outer_logical);
 	Construction::PlaceVolume(Access_Shaft_outer_logical, earth, Access_Shaft_Transform() );
 	Construction::PlaceVolume(Access_Shaft_Air, earth, Access_Shaft_Transform());
 
@@ -879,15 +754,8 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world){
 	//	Construction::Export(earth, folder, file4, arg4 );
 
 
-	//// Put Range Cuts on earth volume
-    // G4Region* cut_region = new G4Region("Earth_Cut_Region");
-    // cut_region->AddRootLogicalVolume(earth);
-    // G4ProductionCuts* cuts = new G4ProductionCuts;
-    // cuts->SetProductionCut(1.0*m,G4ProductionCuts::GetIndex("gamma"));
-    // cuts->SetProductionCut(1.0*m,G4ProductionCuts::GetIndex("e-"));
-    // cuts->SetProductionCut(1.0*m,G4ProductionCuts::GetIndex("e+"));
-    // cuts->SetProductionCut(1.0*m,G4ProductionCuts::GetIndex("proton"));
-    // cut_region->SetProductionCuts(cuts);
+	//// Put Range Cuts on earth volume, configured from /det/region/earth/
+	Construction::Regions::Add("Earth", earth);
 
 
 
@@ -0,0 +1,253 @@
+#include "geometry/Box.hh"
+
+#include <cmath>
+#include <unordered_map>
+
+#include <G4Box.hh>
+#include <G4NavigationHistory.hh>
+#include <G4UnitsTable.hh>
+
+namespace MATHUSLA { namespace MU {
+
+namespace Box { ////////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Readout Placement of a Sensitive Slab_______________________________________________________
+struct _placement {
+  std::size_t layer;
+  int column, row;
+  std::size_t u_axis, v_axis;
+  double u_half, v_half;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Default Segmentation Matches the Physical Strips____________________________________________
+constexpr auto _default_pitch  = 0.045*m;
+constexpr auto _default_length = 4.5*m;
+//----------------------------------------------------------------------------------------------
+
+//__Readout Layers, Bottom to Top_______________________________________________________________
+std::vector<Readout::Layer> _layers{
+  {"HF1",  1, Readout::Orientation::Z, _default_pitch, _default_length, 0},
+  {"HF2",  2, Readout::Orientation::X, _default_pitch, _default_length, 0},
+  {"L0",   3, Readout::Orientation::Z, _default_pitch, _default_length, 0},
+  {"L1",   4, Readout::Orientation::X, _default_pitch, _default_length, 0},
+  {"L2",   5, Readout::Orientation::Z, _default_pitch, _default_length, 0},
+  {"L3",   6, Readout::Orientation::X, _default_pitch, _default_length, 0},
+  {"L4",   7, Readout::Orientation::Z, _default_pitch, _default_length, 0},
+  {"L5",   8, Readout::Orientation::X, _default_pitch, _default_length, 0},
+  {"L6",   9, Readout::Orientation::Z, _default_pitch, _default_length, 0},
+  {"L7",  10, Readout::Orientation::X, _default_pitch, _default_length, 0},
+  {"HW1", 11, Readout::Orientation::Z, _default_pitch, _default_length, 0}};
+std::size_t _selected_layer{};
+//----------------------------------------------------------------------------------------------
+
+//__Sensitive Volume to Readout Placement Map___________________________________________________
+std::unordered_map<const G4VPhysicalVolume*, _placement> _placements;
+//----------------------------------------------------------------------------------------------
+
+//__Find Readout Layer by Name__________________________________________________________________
+std::size_t _find_layer(const std::string& name) {
+  for (std::size_t i{}; i < _layers.size(); ++i)
+    if (_layers[i].name == name)
+      return i;
+  return _layers.size();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Compute Strip Index Along One Axis__________________________________________________________
+bool _strip_index(const double position,
+                  const double half_width,
+                  const double pitch,
+                  const double gap,
+                  std::size_t& index) {
+  const auto offset = position + half_width;
+  if (offset < 0 || offset > 2.0 * half_width)
+    return false;
+  const auto period = pitch + gap;
+  const auto strip = std::floor(offset / period);
+  if (offset - strip * period > pitch)
+    return false;
+  index = static_cast<std::size_t>(strip);
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Strip Count Along One Axis__________________________________________________________________
+std::size_t _strip_count(const double half_width,
+                         const double pitch,
+                         const double gap) {
+  return static_cast<std::size_t>(std::ceil(2.0 * half_width / (pitch + gap)));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Zero-Padded Four Digit Index________________________________________________________________
+std::string _pad_index(const std::size_t index) {
+  const auto name = std::to_string(index);
+  return name.size() < 4UL ? std::string(4UL - name.size(), '0') + name : name;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Layer Name Candidates_______________________________________________________________________
+std::string _layer_candidates() {
+  std::string out;
+  for (const auto& layer : _layers)
+    out += layer.name + ' ';
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Readout Messenger Directory Path____________________________________________________________
+const std::string Readout::MessengerDirectory = "/det/readout/";
+//----------------------------------------------------------------------------------------------
+
+//__Readout Constructor_________________________________________________________________________
+Readout::Readout() : G4UImessenger(MessengerDirectory, "Box Virtual Readout Segmentation.") {
+  _select = CreateCommand<Command::StringArg>("select", "Select Readout Layer to Configure.");
+  _select->SetParameterName("layer", false);
+  _select->SetCandidates(_layer_candidates().c_str());
+  _select->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _select->SetToBeBroadcasted(false);
+
+  _id = CreateCommand<Command::IntegerArg>("id", "Set Layer Number Written to Hit_detId.");
+  _id->SetParameterName("id", false);
+  _id->SetRange("id >= 0");
+  _id->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _id->SetToBeBroadcasted(false);
+
+  _orientation = CreateCommand<Command::StringArg>("orientation", "Set Axis of Fine Segmentation.");
+  _orientation->SetParameterName("axis", false);
+  _orientation->SetCandidates("x z");
+  _orientation->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _orientation->SetToBeBroadcasted(false);
+
+  _pitch = CreateCommand<Command::DoubleUnitArg>("pitch", "Set Strip Width.");
+  _pitch->SetParameterName("pitch", false, false);
+  _pitch->SetRange("pitch > 0");
+  _pitch->SetDefaultUnit("cm");
+  _pitch->SetUnitCandidates("mm cm m");
+  _pitch->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _pitch->SetToBeBroadcasted(false);
+
+  _length = CreateCommand<Command::DoubleUnitArg>("length", "Set Strip Length.");
+  _length->SetParameterName("length", false, false);
+  _length->SetRange("length > 0");
+  _length->SetDefaultUnit("m");
+  _length->SetUnitCandidates("mm cm m");
+  _length->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _length->SetToBeBroadcasted(false);
+
+  _gap = CreateCommand<Command::DoubleUnitArg>("gap", "Set Dead Gap Between Strips.");
+  _gap->SetParameterName("gap", false, false);
+  _gap->SetRange("gap >= 0");
+  _gap->SetDefaultUnit("mm");
+  _gap->SetUnitCandidates("mm cm m");
+  _gap->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _gap->SetToBeBroadcasted(false);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Readout Segmentation.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Readout Messenger Set New Value_____________________________________________________________
+void Readout::SetNewValue(G4UIcommand* command, G4String value) {
+  auto& layer = _layers[_selected_layer];
+  if (command == _select) {
+    const auto index = _find_layer(value);
+    if (index < _layers.size())
+      _selected_layer = index;
+  } else if (command == _id) {
+    layer.id = _id->GetNewIntValue(value);
+  } else if (command == _orientation) {
+    layer.orientation = value == "x" ? Orientation::X : Orientation::Z;
+  } else if (command == _pitch) {
+    layer.pitch = _pitch->GetNewDoubleValue(value);
+  } else if (command == _length) {
+    layer.length = _length->GetNewDoubleValue(value);
+  } else if (command == _gap) {
+    layer.gap = _gap->GetNewDoubleValue(value);
+  } else if (command == _print) {
+    Print();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Clear Registered Placements_________________________________________________________________
+void Readout::Clear() {
+  _placements.clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Register Sensitive Slab with Readout Layer__________________________________________________
+void Readout::Register(const G4VPhysicalVolume* volume,
+                       const std::string& layer,
+                       const int column,
+                       const int row) {
+  const auto index = _find_layer(layer);
+  const auto box = dynamic_cast<const G4Box*>(volume->GetLogicalVolume()->GetSolid());
+  if (index == _layers.size() || !box)
+    return;
+
+  const double half[3] = {box->GetXHalfLength(), box->GetYHalfLength(), box->GetZHalfLength()};
+  const auto thin_axis = half[0] < half[2] ? 0UL : 2UL;
+  const auto u_axis = thin_axis == 2UL ? 0UL : 2UL;
+  _placements[volume] = _placement{index, column, row, u_axis, 1UL, half[u_axis], half[1]};
+}
+//----------------------------------------------------------------------------------------------
+
+//__Map Step to Readout Channel_________________________________________________________________
+bool Readout::Locate(const G4Step* step,
+                     std::string& chamber) {
+  const auto pre_step = step->GetPreStepPoint();
+  const auto touchable = pre_step->GetTouchable();
+  const auto search = _placements.find(touchable->GetVolume());
+  if (search == _placements.cend())
+    return false;
+
+  const auto& placement = search->second;
+  const auto& layer = _layers[placement.layer];
+  const auto midpoint = 0.5 * (pre_step->GetPosition() + step->GetPostStepPoint()->GetPosition());
+  const auto local = touchable->GetHistory()->GetTopTransform().TransformPoint(midpoint);
+
+  const auto fine_u = layer.orientation == Orientation::Z;
+  const auto u_pitch = fine_u ? layer.pitch : layer.length;
+  const auto v_pitch = fine_u ? layer.length : layer.pitch;
+  const auto u_gap = fine_u ? layer.gap : 0.0;
+  const auto v_gap = fine_u ? 0.0 : layer.gap;
+
+  std::size_t u_index, v_index;
+  if (!_strip_index(local[placement.u_axis], placement.u_half, u_pitch, u_gap, u_index)
+      || !_strip_index(local[placement.v_axis], placement.v_half, v_pitch, v_gap, v_index))
+    return false;
+
+  u_index += placement.column * _strip_count(placement.u_half, u_pitch, u_gap);
+  v_index += placement.row * _strip_count(placement.v_half, v_pitch, v_gap);
+
+  chamber = std::to_string(layer.id) + _pad_index(u_index) + _pad_index(v_index);
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Readout Segmentation__________________________________________________________________
+std::ostream& Readout::Print(std::ostream& os) {
+  os << "Box Readout Segmentation:\n";
+  for (const auto& layer : _layers) {
+    os << "  " << layer.name
+       << " | id: "          << layer.id
+       << " | orientation: " << (layer.orientation == Orientation::X ? "x" : "z")
+       << " | pitch: "       << G4BestUnit(layer.pitch, "Length")
+       << " | length: "      << G4BestUnit(layer.length, "Length")
+       << " | gap: "         << G4BestUnit(layer.gap, "Length") << "\n";
+  }
+  return os << "  " << _placements.size() << " sensitive volumes registered\n";
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Box */ //////////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
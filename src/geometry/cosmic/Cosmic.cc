@@ -419,7 +419,9 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
 	+ (x_index < 10UL ? "000" + x_name : (x_index < 100UL ? "00" + x_name : (x_index < 1000UL ? "0" + x_name : x_name))),
     deposit / Units::Energy,
     G4LorentzVector(new_position.t() / Units::Time,   new_position.vect() / Units::Length),
-    G4LorentzVector(new_momentum.e() / Units::Energy, new_momentum.vect() / Units::Momentum)));
+    G4LorentzVector(new_momentum.e() / Units::Energy, new_momentum.vect() / Units::Momentum),
+    track->GetWeight(),
+    step->GetPreStepPoint()->GetWeight()));
 
   return true;
 }
@@ -458,6 +460,7 @@ void Detector::EndOfEvent(G4HCofThisEvent*) {
   root_data.push_back(collection_data[11]);
   root_data.push_back(collection_data[12]);
   root_data.push_back(collection_data[13]);
+  root_data.push_back(collection_data[14]);
 
   const auto gen_particle_data = Tracking::ConvertToAnalysis(GeneratorAction::GetLastEvent(), SaveAll);
   const auto extra_gen_data = Tracking::ConvertToAnalysis(GeneratorAction::GetGenerator()->ExtraDetails());
@@ -465,9 +468,10 @@ void Detector::EndOfEvent(G4HCofThisEvent*) {
   root_data.insert(root_data.cend(), extra_gen_data.cbegin(), extra_gen_data.cend());
 
   Analysis::ROOT::DataEntry metadata;
-  metadata.reserve(2UL);
+  metadata.reserve(3UL);
   metadata.push_back(collection_data[0UL].size());
   metadata.push_back(gen_particle_data[0UL].size());
+  metadata.push_back(EventAction::Weight());
 
   Analysis::ROOT::FillNTuple(DataName, Detector::DataKeyTypes, metadata, root_data);
   if (verboseLevel >= 2 && _hit_collection)
@@ -519,6 +523,9 @@ G4VPhysicalVolume* Detector::ConstructModule(G4LogicalVolume* DetectorVolume, in
 		auto BeamR2 = Construction::OpenBoxVolume("Module" + std::to_string(tag_number) + "BL" + std::to_string(beam_layer) + "PR2", beam_x_edge_length, beam_y_edge_length, module_beam_heights[beam_layer],
 												  beam_thickness, Construction::Material::Iron, Construction::CasingAttributes());
 
+		for (auto beam : {BeamL1, BeamL2, BeamR1, BeamR2})
+			Construction::Regions::Add("Steel", beam);
+
 		Construction::PlaceVolume(BeamL1, ModuleVolume, Construction::Transform(-0.50*module_x_edge_length + 0.50*beam_x_edge_length,
 																				-0.50*module_y_edge_length + 0.50*beam_y_edge_length,
 																				-1.0*module_beam_z_pos[beam_layer]));
@@ -606,6 +613,7 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
 			 x_edge_length, y_edge_length, steel_height,
 			 Construction::Material::Iron,
 			 Construction::CasingAttributes());
+	Construction::Regions::Add("Steel", _steel);
 	Construction::PlaceVolume(_steel, DetectorVolume, Construction::Transform(0.0, 0.0, half_detector_height - 0.5*steel_height));
 
 	//    Construction::Export(DetectorVolume, folder, file, arg4 );
@@ -823,15 +831,8 @@ G4VPhysicalVolume* Detector::ConstructEarth(G4LogicalVolume* world){
 	//	Construction::Export(earth, folder, file4, arg4 );
 
 
-	//// Put Range Cuts on earth volume
-    // G4Region* cut_region = new G4Region("Earth_Cut_Region");
-    // cut_region->AddRootLogicalVolume(earth);
-    // G4ProductionCuts* cuts = new G4ProductionCuts;
-    // cuts->SetProductionCut(1.0*m,G4ProductionCuts::GetIndex("gamma"));
-    // cuts->SetProductionCut(1.0*m,G4ProductionCuts::GetIndex("e-"));
-    // cuts->SetProductionCut(1.0*m,G4ProductionCuts::GetIndex("e+"));
-    // cuts->SetProductionCut(1.0*m,G4ProductionCuts::GetIndex("proton"));
-    // cut_region->SetProductionCuts(cuts);
+	//// Put Range Cuts on earth volume, configured from /det/region/earth/
+	Construction::Regions::Add("Earth", earth);
 
 
 
@@ -126,7 +126,9 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
       name,
       deposit / Units::Energy,
       G4LorentzVector(global_time, position),
-      G4LorentzVector(energy, momentum)));
+      G4LorentzVector(energy, momentum),
+      track->GetWeight(),
+      step->GetPreStepPoint()->GetWeight()));
 
   /* FIXME: add back to data
   Scintillator::PMTPoint pmt_point{0, 0, 0};
@@ -182,6 +184,7 @@ void Detector::EndOfEvent(G4HCofThisEvent*) {
   root_data.push_back(collection_data[11]);
   root_data.push_back(collection_data[12]);
   root_data.push_back(collection_data[13]);
+  root_data.push_back(collection_data[14]);
 
   const auto gen_particle_data = Tracking::ConvertToAnalysis(GeneratorAction::GetLastEvent(), SaveAll);
   const auto extra_gen_data = Tracking::ConvertToAnalysis(GeneratorAction::GetGenerator()->ExtraDetails());
@@ -189,9 +192,10 @@ void Detector::EndOfEvent(G4HCofThisEvent*) {
   root_data.insert(root_data.cend(), extra_gen_data.cbegin(), extra_gen_data.cend());
 
   Analysis::ROOT::DataEntry metadata;
-  metadata.reserve(2);
+  metadata.reserve(3);
   metadata.push_back(collection_data[0].size());
   metadata.push_back(gen_particle_data[0].size());
+  metadata.push_back(EventAction::Weight());
 
   Analysis::ROOT::FillNTuple(DataName, Detector::DataKeyTypes, metadata, root_data);
   if (verboseLevel >= 2 && _hit_collection)
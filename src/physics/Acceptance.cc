@@ -0,0 +1,301 @@
+/*
+ * src/physics/Acceptance.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/Acceptance.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <limits>
+
+#include <G4SystemOfUnits.hh>
+#include <G4UnitsTable.hh>
+
+#include <TFile.h>
+#include <TNamed.h>
+
+#include "geometry/Construction.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Acceptance { /////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Acceptance Prefilter State__________________________________________________________________
+bool _enabled = false;
+std::atomic<bool> _active{false};
+std::atomic<bool> _drop{true};
+Messenger* _messenger = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Detector Envelope and Margin________________________________________________________________
+// the envelope version is bumped whenever its name changes so every thread reloads it
+std::string _envelope;
+std::atomic<std::size_t> _envelope_version{1UL};
+std::atomic<double> _margin{1*m};
+//----------------------------------------------------------------------------------------------
+
+//__Thread-Local Envelope Bounding Box__________________________________________________________
+G4ThreadLocal std::size_t _loaded_version = 0UL;
+G4ThreadLocal bool _envelope_loaded = false;
+G4ThreadLocal double _envelope_min[3], _envelope_max[3];
+//----------------------------------------------------------------------------------------------
+
+//__Acceptance Prefilter Counters_______________________________________________________________
+std::atomic<std::size_t> _event_count{0UL};
+std::atomic<std::size_t> _rejected_count{0UL};
+std::atomic<std::size_t> _tested_count{0UL};
+std::atomic<std::size_t> _dropped_count{0UL};
+//----------------------------------------------------------------------------------------------
+
+//__Load Envelope Bounding Box Grown by the Margin______________________________________________
+bool _load_envelope() {
+  const std::size_t version = _envelope_version;
+  if (_loaded_version != version) {
+    _loaded_version = version;
+    const auto& name = _envelope.empty() ? Construction::Builder::GetDetectorName() : _envelope;
+    G4ThreeVector min, max;
+    _envelope_loaded = Construction::GlobalExtent(name, min, max);
+    if (_envelope_loaded) {
+      const double margin = _margin;
+      for (int i{}; i < 3; ++i) {
+        _envelope_min[i] = min[i] - margin;
+        _envelope_max[i] = max[i] + margin;
+      }
+    } else {
+      std::cout << "[Acceptance] Envelope \"" << name << "\" Not Found. Prefilter Disabled.\n";
+    }
+  }
+  return _envelope_loaded;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Straight Line from Vertex along Momentum Crosses the Envelope______________________
+bool _reaches_envelope(const Physics::Particle& particle) {
+  const double position[3] = {particle.x, particle.y, particle.z};
+  const double direction[3] = {particle.px, particle.py, particle.pz};
+  auto near = 0.0;
+  auto far = std::numeric_limits<double>::infinity();
+  for (int i{}; i < 3; ++i) {
+    if (direction[i] == 0.0) {
+      if (position[i] < _envelope_min[i] || position[i] > _envelope_max[i])
+        return false;
+      continue;
+    }
+    auto t0 = (_envelope_min[i] - position[i]) / direction[i];
+    auto t1 = (_envelope_max[i] - position[i]) / direction[i];
+    if (t0 > t1)
+      std::swap(t0, t1);
+    near = std::max(near, t0);
+    far = std::min(far, t1);
+    if (near > far)
+      return false;
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Acceptance Setting to File____________________________________________________________
+void _write_setting(TFile* file,
+                    const std::string& name,
+                    const std::string& text) {
+  TNamed entry(name.c_str(), text.c_str());
+  file->cd();
+  entry.Write();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Acceptance Prefilter Messenger Directory Path_______________________________________________
+const std::string Messenger::MessengerDirectory = "/gen/acceptance/";
+//----------------------------------------------------------------------------------------------
+
+//__Acceptance Prefilter Messenger Constructor__________________________________________________
+Messenger::Messenger() : G4UImessenger(MessengerDirectory, "Geometric Acceptance Prefilter for Generated Particles.") {
+  _active = CreateCommand<Command::BoolArg>("active",
+    "Test Generated Charged Particles against the Detector Envelope.");
+  _active->SetParameterName("active", false);
+  _active->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _active->SetToBeBroadcasted(false);
+
+  _mode = CreateCommand<Command::StringArg>("mode",
+    "Drop Particles Missing the Envelope or only Flag (Count) them.");
+  _mode->SetParameterName("mode", false);
+  _mode->SetCandidates("drop flag");
+  _mode->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _mode->SetToBeBroadcasted(false);
+
+  _envelope = CreateCommand<Command::StringArg>("envelope",
+    "Volume Used as Detector Envelope (Trailing * Matches Prefix).");
+  _envelope->SetParameterName("volume", false);
+  _envelope->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _envelope->SetToBeBroadcasted(false);
+
+  _margin = CreateCommand<Command::DoubleUnitArg>("margin",
+    "Grow the Envelope by a Margin for Scattering and Bending.");
+  _margin->SetParameterName("margin", false, false);
+  _margin->SetRange("margin >= 0");
+  _margin->SetDefaultUnit("m");
+  _margin->SetUnitCandidates("mm cm m");
+  _margin->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _margin->SetToBeBroadcasted(false);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Acceptance Prefilter.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Acceptance Prefilter Messenger Set New Value________________________________________________
+void Messenger::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _active) {
+    Acceptance::_active = _active->GetNewBoolValue(value);
+  } else if (command == _mode) {
+    Acceptance::_drop = value == "drop";
+  } else if (command == _envelope) {
+    Acceptance::_envelope = value;
+    ++_envelope_version;
+  } else if (command == _margin) {
+    Acceptance::_margin = _margin->GetNewDoubleValue(value);
+    ++_envelope_version;
+  } else if (command == _print) {
+    std::cout << "Acceptance Prefilter: " << (Acceptance::_active ? "active" : "inactive")
+              << " | mode: " << (Acceptance::_drop ? "drop" : "flag")
+              << " | envelope: "
+              << (Acceptance::_envelope.empty() ? Construction::Builder::GetDetectorName()
+                                                : Acceptance::_envelope)
+              << " | margin: " << G4BestUnit(Acceptance::_margin, "Length") << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable Acceptance Prefilter Commands________________________________________________________
+void Enable() {
+  if (_enabled)
+    return;
+  _messenger = new Messenger;
+  _enabled = true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Acceptance Prefilter is Active_____________________________________________________
+bool IsActive() {
+  return _enabled && _active;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Select Generated Particles Heading into the Detector Envelope_______________________________
+bool Select(const Physics::ParticleVector& particles,
+            std::vector<bool>& keep) {
+  keep.assign(particles.size(), true);
+  if (!IsActive() || !_load_envelope())
+    return true;
+
+  std::size_t charged{}, reaching{}, dropped{};
+  for (std::size_t i{}; i < particles.size(); ++i) {
+    if (particles[i].charge() == 0)
+      continue;
+    ++charged;
+    if (_reaches_envelope(particles[i])) {
+      ++reaching;
+    } else if (_drop) {
+      keep[i] = false;
+      ++dropped;
+    }
+  }
+
+  // neutral-only events carry nothing to test and are always kept
+  const auto accepted = !charged || reaching;
+  ++_event_count;
+  _tested_count += charged;
+  if (!accepted) {
+    ++_rejected_count;
+    if (_drop) {
+      dropped += std::count(keep.begin(), keep.end(), true);
+      keep.assign(particles.size(), false);
+    }
+  }
+  _dropped_count += dropped;
+  return accepted || !_drop;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Select Single Generated Particle____________________________________________________________
+bool Select(const Physics::Particle& particle) {
+  std::vector<bool> keep;
+  Select(Physics::ParticleVector{particle}, keep);
+  return keep.front();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Number of Events Seen by the Prefilter______________________________________________________
+std::size_t EventCount() {
+  return _event_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Number of Events without Charged Particles Reaching the Envelope____________________________
+std::size_t RejectedEventCount() {
+  return _rejected_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Number of Generated Particles Dropped by the Prefilter______________________________________
+std::size_t DroppedParticleCount() {
+  return _dropped_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Acceptance Prefilter Counters_________________________________________________________
+void ResetCounters() {
+  _event_count = 0UL;
+  _rejected_count = 0UL;
+  _tested_count = 0UL;
+  _dropped_count = 0UL;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Acceptance Settings and Efficiency____________________________________________________
+void Save(TFile* file) {
+  if (!IsActive() || !file)
+    return;
+
+  const std::size_t events = _event_count;
+  const std::size_t rejected = _rejected_count;
+  const auto efficiency = events ? 1.0 - static_cast<double>(rejected) / events : 1.0;
+  _write_setting(file, "ACCEPTANCE_ENVELOPE",
+    _envelope.empty() ? Construction::Builder::GetDetectorName() : _envelope);
+  _write_setting(file, "ACCEPTANCE_MARGIN", std::to_string(_margin / m));
+  _write_setting(file, "ACCEPTANCE_MODE", _drop ? "drop" : "flag");
+  _write_setting(file, "ACCEPTANCE_EVENTS", std::to_string(events));
+  _write_setting(file, "ACCEPTANCE_REJECTED", std::to_string(rejected));
+  _write_setting(file, "ACCEPTANCE_EFFICIENCY", std::to_string(efficiency));
+  _write_setting(file, "ACCEPTANCE_CHARGED_TESTED", std::to_string(_tested_count));
+  _write_setting(file, "ACCEPTANCE_DROPPED", std::to_string(_dropped_count));
+  std::cout << "\nAcceptance Prefilter: " << events - rejected << " of " << events
+            << " events accepted (efficiency " << efficiency << "), "
+            << _dropped_count << " particles dropped\n";
+  ResetCounters();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Acceptance */ ///////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
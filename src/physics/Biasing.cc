@@ -0,0 +1,566 @@
+/*
+ * src/physics/Biasing.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/Biasing.hh"
+
+#include <algorithm>
+#include <atomic>
+
+#include <G4AutoLock.hh>
+#include <G4GeometrySampler.hh>
+#include <G4IStore.hh>
+#include <G4ImportanceBiasing.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4TransportationManager.hh>
+#include <G4UnitsTable.hh>
+#include <tls.hh>
+
+#include <TFile.h>
+#include <TNamed.h>
+
+#include "ForcedDecay.hh"
+#include "MultiParticleChangeCrossSection.hh"
+#include "physics/Units.hh"
+
+#include "util/string.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Biasing { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Biasing State_______________________________________________________________________________
+bool _enabled = false;
+double _factor = 5000.0;
+int _depth = 0;
+int _limit = 2;
+bool _forced_decay = false;
+Messenger* _messenger = nullptr;
+DecayMessenger* _decay_messenger = nullptr;
+std::vector<std::string> _wrapped;
+std::vector<std::string> _processes{"muonNuclear"};
+std::vector<std::string> _particles{"mu+", "mu-"};
+//----------------------------------------------------------------------------------------------
+
+//__Importance Sampling State___________________________________________________________________
+// volume importances are applied in order, so later entries override earlier ones
+std::string _importance_particle;
+ImportanceMessenger* _importance_messenger = nullptr;
+std::vector<std::pair<std::string, double>> _importances;
+G4Mutex _importance_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Biased Interaction and Forced Decay Counters________________________________________________
+std::atomic<std::size_t> _interaction_count{};
+std::atomic<std::size_t> _forced_decay_count{};
+//----------------------------------------------------------------------------------------------
+
+//__Decay Zone in Detector Coordinates__________________________________________________________
+// (x, y, z) = (world y, depth above the IP, world x), as used by the five-body decay zone
+// check in TrackingAction; the IP is 80 m below the surface in this convention
+constexpr double _zone_ip_depth = 80*m;
+G4ThreeVector _zone_min{-49.5*m, 60.03*m,   70*m};
+G4ThreeVector _zone_max{ 49.5*m, 87.095*m, 170*m};
+//----------------------------------------------------------------------------------------------
+
+//__Transform World Vector to Decay Zone Coordinates____________________________________________
+G4ThreeVector _to_zone(const G4ThreeVector& position) {
+  return G4ThreeVector(position.y(), _zone_ip_depth - position.z(), position.x());
+}
+G4ThreeVector _to_zone_direction(const G4ThreeVector& direction) {
+  return G4ThreeVector(direction.y(), -direction.z(), direction.x());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Parse Name List_____________________________________________________________________________
+std::vector<std::string> _parse_names(const std::string& value) {
+  std::vector<std::string> tokens, out;
+  util::string::split(value, tokens, " ,");
+  for (auto& token : tokens) {
+    util::string::strip(token);
+    if (!token.empty())
+      out.push_back(token);
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Join Name List______________________________________________________________________________
+const std::string _join_names(const std::vector<std::string>& names) {
+  std::string out;
+  for (const auto& name : names)
+    out += (out.empty() ? "" : " ") + name;
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Join Volume Importances_____________________________________________________________________
+const std::string _join_importances() {
+  std::string out;
+  for (const auto& entry : _importances)
+    out += (out.empty() ? "" : " ") + entry.first + "=" + std::to_string(entry.second);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Importance of Physical Volume by Name (Trailing * Matches Prefix)___________________________
+double _importance(const std::string& name,
+                   const double inherited) {
+  auto out = inherited;
+  for (const auto& entry : _importances) {
+    const auto& pattern = entry.first;
+    if (!pattern.empty() && pattern.back() == '*'
+        ? name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0
+        : name == pattern)
+      out = entry.second;
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Importances of Volume Tree______________________________________________________________
+// volumes without an importance inherit the importance of their mother volume
+void _set_importances(G4IStore* store,
+                      const G4VPhysicalVolume* volume,
+                      const double inherited) {
+  const auto importance = _importance(volume->GetName(), inherited);
+  const auto copies = volume->IsReplicated() ? volume->GetMultiplicity() : 1;
+  for (int i{}; i < copies; ++i) {
+    const auto copy = volume->IsReplicated() ? i : volume->GetCopyNo();
+    if (store->IsKnown(G4GeometryCell(*volume, copy)))
+      store->ChangeImportance(importance, *volume, copy);
+    else
+      store->AddImportanceGeometryCell(importance, *volume, copy);
+  }
+  const auto logical = volume->GetLogicalVolume();
+  for (std::size_t i{}; i < logical->GetNoDaughters(); ++i)
+    _set_importances(store, logical->GetDaughter(i), importance);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Setting to ROOT File__________________________________________________________________
+void _write_setting(TFile* file,
+                    const std::string& name,
+                    const std::string& text) {
+  TNamed entry(name.c_str(), text.c_str());
+  file->cd();
+  entry.Write();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Biasing Messenger Directory Path____________________________________________________________
+const std::string Messenger::MessengerDirectory = "/bias/";
+//----------------------------------------------------------------------------------------------
+
+//__Biasing Messenger Constructor_______________________________________________________________
+Messenger::Messenger() : G4UImessenger(MessengerDirectory, "Cross-Section Biasing in Earth.") {
+  _factor = CreateCommand<Command::DoubleArg>("factor",
+    "Set Cross-Section Multiplication Factor.");
+  _factor->SetParameterName("factor", false);
+  _factor->SetRange("factor > 0");
+  _factor->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _factor->SetToBeBroadcasted(false);
+
+  _processes = CreateCommand<Command::StringArg>("processes",
+    "Set Biased Processes by Name.");
+  _processes->SetParameterName("processes", false);
+  _processes->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _processes->SetToBeBroadcasted(false);
+
+  _particles = CreateCommand<Command::StringArg>("particles",
+    "Set Biased Particles (Subset of --bias Particles).");
+  _particles->SetParameterName("particles", false);
+  _particles->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _particles->SetToBeBroadcasted(false);
+
+  _depth = CreateCommand<Command::IntegerArg>("depth",
+    "Set Maximum Track Generation to Bias (0 for Primaries, -1 for All).");
+  _depth->SetParameterName("depth", false);
+  _depth->SetRange("depth >= -1");
+  _depth->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _depth->SetToBeBroadcasted(false);
+
+  _limit = CreateCommand<Command::IntegerArg>("limit",
+    "Set Maximum Biased Interactions per Track (-1 for No Limit).");
+  _limit->SetParameterName("limit", false);
+  _limit->SetRange("limit >= -1");
+  _limit->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _limit->SetToBeBroadcasted(false);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Biasing Settings.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Biasing Messenger Set New Value_____________________________________________________________
+void Messenger::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _factor) {
+    Biasing::_factor = _factor->GetNewDoubleValue(value);
+  } else if (command == _processes) {
+    Biasing::_processes = _parse_names(value);
+  } else if (command == _particles) {
+    auto particles = _parse_names(value);
+    for (const auto& particle : particles) {
+      if (std::find(_wrapped.cbegin(), _wrapped.cend(), particle) == _wrapped.cend()) {
+        std::cout << "[Biasing] Particle \"" << particle << "\" is not Wrapped. "
+                  << "Add it to --bias=<particles> to Bias it.\n";
+        return;
+      }
+    }
+    Biasing::_particles = particles;
+  } else if (command == _depth) {
+    Biasing::_depth = _depth->GetNewIntValue(value);
+  } else if (command == _limit) {
+    Biasing::_limit = _limit->GetNewIntValue(value);
+  } else if (command == _print) {
+    std::cout << "Biasing: " << (_enabled ? "on" : "off")
+              << " | factor: " << Biasing::_factor
+              << " | depth: " << Biasing::_depth
+              << " | limit: " << Biasing::_limit
+              << " | processes: " << _join_names(Biasing::_processes)
+              << " | particles: " << _join_names(Biasing::_particles)
+              << " | wrapped: " << _join_names(_wrapped) << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Forced Decay Messenger Directory Path_______________________________________________________
+const std::string DecayMessenger::MessengerDirectory = "/bias/decay/";
+//----------------------------------------------------------------------------------------------
+
+//__Forced Decay Messenger Constructor__________________________________________________________
+DecayMessenger::DecayMessenger() : G4UImessenger(MessengerDirectory, "Forced Decay in the Decay Zone.") {
+  _zone_min = CreateCommand<Command::ThreeVectorUnitArg>("zone_min",
+    "Set Lower Corner of Decay Zone in Detector Coordinates.");
+  _zone_min->SetParameterName("x", "y", "z", false, false);
+  _zone_min->SetDefaultUnit("m");
+  _zone_min->SetUnitCandidates("mm cm m");
+  _zone_min->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _zone_min->SetToBeBroadcasted(false);
+
+  _zone_max = CreateCommand<Command::ThreeVectorUnitArg>("zone_max",
+    "Set Upper Corner of Decay Zone in Detector Coordinates.");
+  _zone_max->SetParameterName("x", "y", "z", false, false);
+  _zone_max->SetDefaultUnit("m");
+  _zone_max->SetUnitCandidates("mm cm m");
+  _zone_max->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _zone_max->SetToBeBroadcasted(false);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Decay Zone.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Forced Decay Messenger Set New Value________________________________________________________
+void DecayMessenger::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _zone_min) {
+    Biasing::_zone_min = _zone_min->GetNew3VectorValue(value);
+  } else if (command == _zone_max) {
+    Biasing::_zone_max = _zone_max->GetNew3VectorValue(value);
+  } else if (command == _print) {
+    std::cout << "Decay Zone: " << (_forced_decay ? "forced" : "analog")
+              << " | min: (" << G4BestUnit(Biasing::_zone_min.x(), "Length") << ", "
+                             << G4BestUnit(Biasing::_zone_min.y(), "Length") << ", "
+                             << G4BestUnit(Biasing::_zone_min.z(), "Length") << ")"
+              << " | max: (" << G4BestUnit(Biasing::_zone_max.x(), "Length") << ", "
+                             << G4BestUnit(Biasing::_zone_max.y(), "Length") << ", "
+                             << G4BestUnit(Biasing::_zone_max.z(), "Length") << ")\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Importance Sampling Messenger Directory Path________________________________________________
+const std::string ImportanceMessenger::MessengerDirectory = "/bias/importance/";
+//----------------------------------------------------------------------------------------------
+
+//__Importance Sampling Messenger Constructor___________________________________________________
+ImportanceMessenger::ImportanceMessenger()
+    : G4UImessenger(MessengerDirectory, "Geometric Importance Sampling.") {
+  _set = CreateCommand<Command::StringArg>("set",
+    "Set Importance of Volume: <volume> <importance> (Trailing * Matches Prefix).");
+  _set->SetParameterName("importance", false);
+  _set->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set->SetToBeBroadcasted(false);
+
+  _clear = CreateCommand<Command::NoArg>("clear", "Remove All Volume Importances.");
+  _clear->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _clear->SetToBeBroadcasted(false);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Volume Importances.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Importance Sampling Messenger Set New Value_________________________________________________
+void ImportanceMessenger::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _set) {
+    const auto tokens = _parse_names(value);
+    if (tokens.size() != 2UL) {
+      std::cout << "[Biasing] Expected: <volume> <importance>\n";
+      return;
+    }
+    try {
+      const auto importance = std::stod(tokens[1]);
+      if (importance <= 0) {
+        std::cout << "[Biasing] Importance must be Positive.\n";
+        return;
+      }
+      _importances.emplace_back(tokens[0], importance);
+    } catch (...) {
+      std::cout << "[Biasing] Invalid Importance \"" << tokens[1] << "\".\n";
+    }
+  } else if (command == _clear) {
+    _importances.clear();
+  } else if (command == _print) {
+    std::cout << "Importance Sampling: " << _importance_particle
+              << " | default: mother volume (world 1) | volumes: " << _join_importances() << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable Cross-Section Biasing for Wrapped Particles__________________________________________
+void Enable(const std::vector<std::string>& wrapped) {
+  if (_enabled)
+    return;
+  _wrapped = wrapped;
+  _particles = wrapped;
+  _messenger = new Messenger;
+  _enabled = true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Cross-Section Biasing is Enabled___________________________________________________
+bool IsEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Wrapped Particle Names______________________________________________________________________
+const std::vector<std::string>& Wrapped() {
+  return _wrapped;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attach Biasing Operator to Logical Volume (Once per Thread)_________________________________
+void Attach(const std::string& volume) {
+  auto logical = G4LogicalVolumeStore::GetInstance()->GetVolume(volume, false);
+  if (!_enabled || !logical)
+    return;
+  auto biasingOperator = new MultiParticleChangeCrossSection;
+  for (const auto& particle : _wrapped)
+    biasingOperator->AddParticle(particle);
+  biasingOperator->AttachTo(logical);
+  G4cout << " Attaching biasing operator " << biasingOperator->GetName()
+         << " to logical volume " << logical->GetName()
+         << G4endl;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable Forced Decay in the Decay Zone_______________________________________________________
+void EnableForcedDecay() {
+  if (_forced_decay)
+    return;
+  _decay_messenger = new DecayMessenger;
+  _forced_decay = true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Forced Decay is Enabled____________________________________________________________
+bool IsForcedDecayEnabled() {
+  return _forced_decay;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attach Forced Decay Operator to Unbiased Volumes (Once per Thread)__________________________
+void AttachForcedDecay() {
+  if (!_forced_decay)
+    return;
+  auto biasingOperator = new ForcedDecay;
+  std::size_t count{};
+  for (auto volume : *G4LogicalVolumeStore::GetInstance()) {
+    if (G4VBiasingOperator::GetBiasingOperator(volume))
+      continue;
+    biasingOperator->AttachTo(volume);
+    ++count;
+  }
+  G4cout << " Attaching biasing operator " << biasingOperator->GetName()
+         << " to " << count << " logical volumes"
+         << G4endl;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable Geometric Importance Sampling for Particle (Before Initialization)___________________
+G4VPhysicsConstructor* EnableImportanceSampling(const std::string& particle) {
+  if (!_importance_particle.empty())
+    return nullptr;
+  _importance_particle = particle;
+  _importance_messenger = new ImportanceMessenger;
+  // sampling in the mass geometry, the world volume is only used for parallel worlds
+  auto sampler = new G4GeometrySampler(
+    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume(),
+    particle);
+  sampler->SetParallel(false);
+  return new G4ImportanceBiasing(sampler);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Particle is Importance Sampled_____________________________________________________
+bool IsImportanceSampled(const std::string& particle) {
+  return !_importance_particle.empty() && particle == _importance_particle;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Fill Importance Store from Volume Importances (Once per Thread and Run)_____________________
+void ApplyImportances() {
+  if (_importance_particle.empty())
+    return;
+  const auto world = G4TransportationManager::GetTransportationManager()
+                       ->GetNavigatorForTracking()->GetWorldVolume();
+  if (!world)
+    return;
+  G4AutoLock lock(&_importance_mutex);
+  _set_importances(G4IStore::GetInstance(), world, 1.0);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Position is in the Decay Zone______________________________________________________
+bool InDecayZone(const G4ThreeVector& position) {
+  const auto zone = _to_zone(position);
+  return _zone_min.x() < zone.x() && zone.x() < _zone_max.x()
+      && _zone_min.y() < zone.y() && zone.y() < _zone_max.y()
+      && _zone_min.z() < zone.z() && zone.z() < _zone_max.z();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Straight-Line Distance to Decay Zone Exit (Zero Outside)____________________________________
+double DistanceToDecayZoneExit(const G4ThreeVector& position,
+                               const G4ThreeVector& direction) {
+  if (!InDecayZone(position))
+    return 0;
+  const auto zone = _to_zone(position);
+  const auto zone_direction = _to_zone_direction(direction);
+  auto distance = DBL_MAX;
+  for (std::size_t i{}; i < 3UL; ++i) {
+    if (zone_direction[i] > 0)
+      distance = std::min(distance, (_zone_max[i] - zone[i]) / zone_direction[i]);
+    else if (zone_direction[i] < 0)
+      distance = std::min(distance, (_zone_min[i] - zone[i]) / zone_direction[i]);
+  }
+  return distance == DBL_MAX ? 0 : distance;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Cross-Section Multiplication Factor_________________________________________________________
+double Factor() {
+  return _factor;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Process is Biased__________________________________________________________________
+bool IsBiasedProcess(const std::string& process) {
+  return std::find(_processes.cbegin(), _processes.cend(), process) != _processes.cend();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Particle is Biased_________________________________________________________________
+bool IsBiasedParticle(const std::string& particle) {
+  return std::find(_particles.cbegin(), _particles.cend(), particle) != _particles.cend();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Maximum Biased Track Generation_____________________________________________________________
+int Depth() {
+  return _depth;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Maximum Biased Interactions per Track_______________________________________________________
+int InteractionLimit() {
+  return _limit;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Count Biased Interaction____________________________________________________________________
+void CountInteraction() {
+  ++_interaction_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Biased Interaction Count____________________________________________________________________
+std::size_t InteractionCount() {
+  return _interaction_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Count Forced Decay__________________________________________________________________________
+void CountForcedDecay() {
+  ++_forced_decay_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Forced Decay Count__________________________________________________________________________
+std::size_t ForcedDecayCount() {
+  return _forced_decay_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Biased Interaction and Forced Decay Counters__________________________________________
+void ResetCounters() {
+  _interaction_count = 0;
+  _forced_decay_count = 0;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Biasing Settings______________________________________________________________________
+void Save(TFile* file) {
+  if (!file)
+    return;
+  if (_enabled) {
+    _write_setting(file, "BIAS_FACTOR", std::to_string(_factor));
+    _write_setting(file, "BIAS_PROCESSES", _join_names(_processes));
+    _write_setting(file, "BIAS_PARTICLES", _join_names(_particles));
+    _write_setting(file, "BIAS_DEPTH", std::to_string(_depth));
+    _write_setting(file, "BIAS_LIMIT", std::to_string(_limit));
+    _write_setting(file, "BIAS_INTERACTIONS", std::to_string(_interaction_count));
+  }
+  if (_forced_decay) {
+    _write_setting(file, "FORCED_DECAY_ZONE_MIN", "(" + std::to_string(_zone_min.x() / Units::Length) + ", "
+                                                      + std::to_string(_zone_min.y() / Units::Length) + ", "
+                                                      + std::to_string(_zone_min.z() / Units::Length) + ")");
+    _write_setting(file, "FORCED_DECAY_ZONE_MAX", "(" + std::to_string(_zone_max.x() / Units::Length) + ", "
+                                                      + std::to_string(_zone_max.y() / Units::Length) + ", "
+                                                      + std::to_string(_zone_max.z() / Units::Length) + ")");
+    _write_setting(file, "FORCED_DECAYS", std::to_string(_forced_decay_count));
+  }
+  if (!_importance_particle.empty()) {
+    _write_setting(file, "IMPORTANCE_PARTICLE", _importance_particle);
+    _write_setting(file, "IMPORTANCES", _join_importances());
+  }
+  ResetCounters();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Biasing */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
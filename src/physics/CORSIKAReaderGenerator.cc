@@ -1,18 +1,32 @@
 
 #include "physics/CORSIKAReaderGenerator.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <G4ThreeVector.hh>
 #include <G4Threading.hh>
 #include <G4AutoLock.hh>
+#include <G4ParticleTable.hh>
+#include <G4UIcommand.hh>
 #include <G4MTRunManager.hh>
+#include <G4RunManager.hh>
 #include <tls.hh>
 
+#include <TChain.h>
 #include <TFile.h>
 #include <TTree.h>
 #include <TLeaf.h>
+#include <TTreeReader.h>
+#include <TTreeReaderArray.h>
+#include <TTreeReaderValue.h>
 
 #include "geometry/Construction.hh"
 #include "physics/Units.hh"
 #include "util/random.hh"
+#include "util/string.hh"
 #include "action.hh"
 #include "tracking.hh"
 
@@ -108,11 +122,20 @@ namespace { ////////////////////////////////////////////////////////////////////
 G4Mutex _mutex = G4MUTEX_INITIALIZER;
 //----------------------------------------------------------------------------------------------
 
+//__Number of Worker Threads and Index of Current Thread________________________________________
+std::pair<std::size_t, std::size_t> _thread_slot() {
+  const auto threads = G4Threading::GetNumberOfRunningWorkerThreads();
+  const auto thread = G4Threading::G4GetThreadId();
+  return {threads > 0 ? threads : 1, thread > 0 ? thread : 0};
+}
+//----------------------------------------------------------------------------------------------
+
 //__Get Range of Thread in Data_________________________________________________________________
 std::pair<std::size_t, std::size_t> _calculate_thread_range(const std::size_t total) {
-  const auto bucket_size = std::ceil(total / static_cast<long double>(G4Threading::GetNumberOfRunningWorkerThreads()));
-  const auto first = bucket_size * G4Threading::G4GetThreadId();
-  return {first, first + bucket_size};
+  const auto slot = _thread_slot();
+  const auto bucket_size = (total + slot.first - 1) / slot.first;
+  const auto first = std::min(total, bucket_size * slot.second);
+  return {first, std::min(total, first + bucket_size)};
 }
 //----------------------------------------------------------------------------------------------
 
@@ -189,86 +212,204 @@ TLeaf* _load_leaf(TTree* tree,
 }
 //----------------------------------------------------------------------------------------------
 
-//__Event Subtree Struct________________________________________________________________________
-struct _event_subtree {
-  TTree *spec_tree, *data_tree;
-  TLeaf *event_id, *energy, *theta, *phi, *z0, *electron_count, *muon_count, *hadron_count,
-        *id, *t, *x, *y, *z, *obs, *px, *py, *pz, *weight,
-        *primary_id,
-        *energy_slope, *energy_min, *energy_max,
-        *azimuth_min, *azimuth_max, *zenith_min, *zenith_max;
+//__Shower Column Read through TTreeReader______________________________________________________
+// TTreeReader needs the stored type, so it is taken from the leaf in the file
+template<template<class> class Reader>
+class _column {
+public:
+  _column(TTreeReader& reader,
+          TTree* tree,
+          const std::string& name) {
+    const auto leaf = tree->GetLeaf(name.c_str());
+    const std::string type = leaf ? leaf->GetTypeName() : "Double_t";
+    if (type == "Float_t")
+      _float.reset(new Reader<Float_t>(reader, name.c_str()));
+    else if (type == "Int_t")
+      _int.reset(new Reader<Int_t>(reader, name.c_str()));
+    else
+      _double.reset(new Reader<Double_t>(reader, name.c_str()));
+  }
 
-  _event_subtree(TTree* spec, TTree* data) : spec_tree(spec), data_tree(data) {
-    data_tree->SetBranchStatus("*", 0);
-    spec_tree->SetBranchStatus("*", 0);
-    event_id       = _load_leaf(data_tree, "shower.EventID");
-    energy         = _load_leaf(data_tree, "shower.Energy");
-    theta          = _load_leaf(data_tree, "shower.Theta");
-    phi            = _load_leaf(data_tree, "shower.Phi");
-    z0             = _load_leaf(data_tree, "shower.FirstHeight");
-    electron_count = _load_leaf(data_tree, "shower.nElectrons");
-    muon_count     = _load_leaf(data_tree, "shower.nMuons");
-    hadron_count   = _load_leaf(data_tree, "shower.nHadrons");
-    id             = _load_leaf(data_tree, "particle..ParticleID");
-    t              = _load_leaf(data_tree, "particle..Time");
-    x              = _load_leaf(data_tree, "particle..x");
-    y              = _load_leaf(data_tree, "particle..y");
-    z              = _load_leaf(data_tree, "particle..ObservationLevel");
-    px             = _load_leaf(data_tree, "particle..Px");
-    py             = _load_leaf(data_tree, "particle..Py");
-    pz             = _load_leaf(data_tree, "particle..Pz");
-    weight         = _load_leaf(data_tree, "particle..Weight");
-    obs            = _load_leaf(spec_tree, "run.ObservationLevel");
-    primary_id     = _load_leaf(spec_tree, "run.ParticleID");
-    energy_slope   = _load_leaf(spec_tree, "run.EnergySlope");
-    energy_min     = _load_leaf(spec_tree, "run.EnergyMin");
-    energy_max     = _load_leaf(spec_tree, "run.EnergyMax");
-    azimuth_min    = _load_leaf(spec_tree, "run.AzimuthMin");
-    azimuth_max    = _load_leaf(spec_tree, "run.AzimuthMax");
-    zenith_min     = _load_leaf(spec_tree, "run.ZenithMin");
-    zenith_max     = _load_leaf(spec_tree, "run.ZenithMax");
+protected:
+  std::unique_ptr<Reader<Double_t>> _double;
+  std::unique_ptr<Reader<Float_t>> _float;
+  std::unique_ptr<Reader<Int_t>> _int;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Shower Value Column_________________________________________________________________________
+struct _value_column : _column<TTreeReaderValue> {
+  using _column::_column;
+  double get() {
+    return _double ? **_double : (_float ? **_float : **_int);
   }
+};
+//----------------------------------------------------------------------------------------------
 
-  void load_config(CORSIKAConfig& config) {
-    config.primary_id     = _convert_primary_id(primary_id->GetValue(0));
-    config.energy         = energy->GetValue(0);
-    config.theta          = theta->GetValue(0);
-    config.phi            = phi->GetValue(0);
-    config.z0             = z0->GetValue(0);
-    config.electron_count = electron_count->GetValue(0);
-    config.muon_count     = muon_count->GetValue(0);
-    config.hadron_count   = hadron_count->GetValue(0);
-    config.energy_slope   = energy_slope->GetValue(0);
-    config.energy_min     = energy_min->GetValue(0);
-    config.energy_max     = energy_max->GetValue(0);
-    config.azimuth_min    = azimuth_min->GetValue(0);
-    config.azimuth_max    = azimuth_max->GetValue(0);
-    config.zenith_min     = zenith_min->GetValue(0);
-    config.zenith_max     = zenith_max->GetValue(0);
+//__Particle Array Column (Converted to Double in One Pass per Shower)__________________________
+struct _array_column : _column<TTreeReaderArray> {
+  using _column::_column;
+  void copy(std::vector<double>& out) {
+    if (_double)
+      _copy(*_double, out);
+    else if (_float)
+      _copy(*_float, out);
+    else
+      _copy(*_int, out);
+  }
+
+private:
+  template<class T>
+  static void _copy(TTreeReaderArray<T>& array,
+                    std::vector<double>& out) {
+    out.resize(array.GetSize());
+    for (std::size_t i{}; i < out.size(); ++i)
+      out[i] = array[i];
   }
 };
 //----------------------------------------------------------------------------------------------
 
-//__Load Particle from Subtree__________________________________________________________________
-void _load_particle(const std::size_t i,
-                    _event_subtree& subtree,
-                    const int particle_id,
-                    const Particle& origin,
-                    CORSIKAEvent& out) {
-  const auto position = _cms_rotation(subtree.x->GetValue(i) * cm,
-                                      subtree.y->GetValue(i) * cm);
-  const auto momentum = _cms_rotation(subtree.px->GetValue(i) * GeVperC,
-                                      subtree.py->GetValue(i) * GeVperC);
-  out.push_back(particle_id,
-                subtree.t->GetValue(i) * ns,
-                position.first + origin.x,
-                position.second + origin.y,
-                -(subtree.obs->GetValue(subtree.z->GetValue(i) - 1) * cm - origin.z),
-                momentum.first,
-                momentum.second,
-                subtree.pz->GetValue(i) * GeVperC,
-                subtree.weight->GetValue(i));
-}
+//__CORSIKA File Opened for Reading Showers_____________________________________________________
+// shower and particle branches are read through TTreeReader behind a TTreeCache holding
+// exactly those branches, so a shower costs a few vectored reads of whole clusters rather
+// than one TLeaf::GetValue call per particle value
+class _shower_file {
+public:
+  _shower_file(const std::string& path,
+               const Long64_t cache_size)
+      : _file(TFile::Open(path.c_str(), "READ")), _entries(0LL) {
+    if (!_file || _file->IsZombie())
+      return;
+    auto spec_tree = dynamic_cast<TTree*>(_file->Get("run"));
+    auto data_tree = dynamic_cast<TTree*>(_file->Get("sim"));
+    if (!spec_tree || !data_tree || spec_tree->GetEntries() != 1 || data_tree->GetEntries() <= 0)
+      return;
+
+    spec_tree->SetBranchStatus("*", 0);
+    const auto obs = _load_leaf(spec_tree, "run.ObservationLevel");
+    const auto primary_id   = _load_leaf(spec_tree, "run.ParticleID");
+    const auto energy_slope = _load_leaf(spec_tree, "run.EnergySlope");
+    const auto energy_min   = _load_leaf(spec_tree, "run.EnergyMin");
+    const auto energy_max   = _load_leaf(spec_tree, "run.EnergyMax");
+    const auto azimuth_min  = _load_leaf(spec_tree, "run.AzimuthMin");
+    const auto azimuth_max  = _load_leaf(spec_tree, "run.AzimuthMax");
+    const auto zenith_min   = _load_leaf(spec_tree, "run.ZenithMin");
+    const auto zenith_max   = _load_leaf(spec_tree, "run.ZenithMax");
+    spec_tree->GetEntry(0);
+    _run.primary_id   = _convert_primary_id(primary_id->GetValue(0));
+    _run.energy_slope = energy_slope->GetValue(0);
+    _run.energy_min   = energy_min->GetValue(0);
+    _run.energy_max   = energy_max->GetValue(0);
+    _run.azimuth_min  = azimuth_min->GetValue(0);
+    _run.azimuth_max  = azimuth_max->GetValue(0);
+    _run.zenith_min   = zenith_min->GetValue(0);
+    _run.zenith_max   = zenith_max->GetValue(0);
+    for (int i{}; i < obs->GetLen(); ++i)
+      _levels.push_back(obs->GetValue(i) * cm);
+
+    data_tree->SetCacheSize(cache_size);
+    _reader.reset(new TTreeReader(data_tree));
+    const auto value = [&](const std::string& name) {
+      data_tree->AddBranchToCache(name.c_str(), true);
+      return new _value_column(*_reader, data_tree, name);
+    };
+    const auto array = [&](const std::string& name) {
+      data_tree->AddBranchToCache(name.c_str(), true);
+      return new _array_column(*_reader, data_tree, name);
+    };
+    _energy.reset(value("shower.Energy"));
+    _theta.reset(value("shower.Theta"));
+    _phi.reset(value("shower.Phi"));
+    _z0.reset(value("shower.FirstHeight"));
+    _electron_count.reset(value("shower.nElectrons"));
+    _muon_count.reset(value("shower.nMuons"));
+    _hadron_count.reset(value("shower.nHadrons"));
+    _id.reset(array("particle..ParticleID"));
+    _t.reset(array("particle..Time"));
+    _x.reset(array("particle..x"));
+    _y.reset(array("particle..y"));
+    _z.reset(array("particle..ObservationLevel"));
+    _px.reset(array("particle..Px"));
+    _py.reset(array("particle..Py"));
+    _pz.reset(array("particle..Pz"));
+    _weight.reset(array("particle..Weight"));
+    data_tree->StopCacheLearningPhase();
+    _entries = data_tree->GetEntries();
+  }
+
+  bool good() const {
+    return _entries > 0LL;
+  }
+
+  Long64_t entries() const {
+    return _entries;
+  }
+
+  bool load(const Long64_t entry,
+            const Particle& origin,
+            CORSIKAConfig& config,
+            CORSIKAEvent& event) {
+    event.clear();
+    if (!good() || _reader->SetEntry(entry) != TTreeReader::kEntryValid)
+      return false;
+
+    config.primary_id     = _run.primary_id;
+    config.energy_slope   = _run.energy_slope;
+    config.energy_min     = _run.energy_min;
+    config.energy_max     = _run.energy_max;
+    config.azimuth_min    = _run.azimuth_min;
+    config.azimuth_max    = _run.azimuth_max;
+    config.zenith_min     = _run.zenith_min;
+    config.zenith_max     = _run.zenith_max;
+    config.energy         = _energy->get();
+    config.theta          = _theta->get();
+    config.phi            = _phi->get();
+    config.z0             = _z0->get();
+    config.electron_count = _electron_count->get();
+    config.muon_count     = _muon_count->get();
+    config.hadron_count   = _hadron_count->get();
+
+    _id->copy(_ids);
+    _t->copy(_ts);
+    _x->copy(_xs);
+    _y->copy(_ys);
+    _z->copy(_zs);
+    _px->copy(_pxs);
+    _py->copy(_pys);
+    _pz->copy(_pzs);
+    _weight->copy(_weights);
+
+    event.reserve(_ids.size());
+    for (std::size_t i{}; i < _ids.size(); ++i) {
+      const auto particle_id_pair = _convert_primary_id(static_cast<int>(_ids[i]));
+      if ((std::abs(particle_id_pair.first) == 13 && particle_id_pair.second > 10))
+        continue;
+      const auto position = _cms_rotation(_xs[i] * cm, _ys[i] * cm);
+      const auto momentum = _cms_rotation(_pxs[i] * GeVperC, _pys[i] * GeVperC);
+      event.push_back(particle_id_pair.first,
+                      _ts[i] * ns,
+                      position.first + origin.x,
+                      position.second + origin.y,
+                      -(_levels[static_cast<std::size_t>(_zs[i]) - 1] - origin.z),
+                      momentum.first,
+                      momentum.second,
+                      _pzs[i] * GeVperC,
+                      _weights[i]);
+    }
+    return true;
+  }
+
+private:
+  std::unique_ptr<TFile> _file;
+  std::unique_ptr<TTreeReader> _reader;
+  std::unique_ptr<_value_column> _energy, _theta, _phi, _z0,
+                                 _electron_count, _muon_count, _hadron_count;
+  std::unique_ptr<_array_column> _id, _t, _x, _y, _z, _px, _py, _pz, _weight;
+  std::vector<double> _ids, _ts, _xs, _ys, _zs, _pxs, _pys, _pzs, _weights;
+  std::vector<double> _levels;
+  CORSIKAConfig _run;
+  Long64_t _entries;
+};
 //----------------------------------------------------------------------------------------------
 
 //__Perform Random Translation of Event Vector__________________________________________________
@@ -279,45 +420,159 @@ std::pair<double, double> _random_translation(double max_radius) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Spread De-Thinned Copy in Position and Direction____________________________________________
+// copies are placed uniformly in a disk around the thinned particle in the observation plane,
+// with directions uniform in a cone around its momentum
+Particle _spread(const Particle& particle,
+                 const double radius,
+                 const double angle) {
+  auto out = particle;
+  const auto shift = _random_translation(radius);
+  out.x += shift.first;
+  out.y += shift.second;
+
+  G4ThreeVector momentum(particle.px, particle.py, particle.pz);
+  const auto cos_theta = 1.0 - util::random::uniform() * (1.0 - std::cos(angle));
+  const auto phi = 2.0L * 3.141592653589793238462643383279502884L * util::random::uniform();
+  const auto axis = momentum.unit();
+  momentum.rotate(std::acos(cos_theta), axis.orthogonal());
+  momentum.rotate(phi, axis);
+  out.px = momentum.x();
+  out.py = momentum.y();
+  out.pz = momentum.z();
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Collect Data From Tree______________________________________________________________________
 void _collect_source(const std::string& path,
+                     const Long64_t cache_size,
                      const Particle& origin,
                      CORSIKAConfig& config,
                      CORSIKAEvent& event) {
-  TFile file(path.c_str(), "READ");
-  if (!file.IsZombie()) {
-    std::cout << "\n\nLoading Data from " + path + " ...\n\n";
-    file.cd();
-    auto spec_tree = dynamic_cast<TTree*>(file.Get("run"));
-    auto data_tree = dynamic_cast<TTree*>(file.Get("sim"));
-    const auto data_entries = data_tree->GetEntries();
-    if (spec_tree && data_tree && (spec_tree->GetEntries() == 1) && (data_entries > 0)) {
-      _event_subtree subtree{spec_tree, data_tree};
-      subtree.spec_tree->GetEntry(0);
-      subtree.data_tree->GetEntry(config.event_id);
-      subtree.load_config(config);
-
-      const auto signed_event_size = subtree.id->GetLen();
-      const auto event_size = signed_event_size > 0 ? static_cast<std::size_t>(signed_event_size) : 0UL;
-
-      event.reserve(event_size);
-      for (std::size_t i{}; i < event_size; ++i) {
-        const auto particle_id_pair = _convert_primary_id(subtree.id->GetValue(i));
-        if ((std::abs(particle_id_pair.first) == 13 && particle_id_pair.second > 10))
-          continue;
-        _load_particle(i, subtree, particle_id_pair.first, origin, event);
-      }
+  std::cout << "\n\nLoading Data from " + path + " ...\n\n";
+  _shower_file file(path, cache_size);
+  if (file.good()) {
+    file.load(config.event_id, origin, config, event);
+    if (event.empty()) {
+      std::cout << "No Event in CORSIKA File. Exiting.\n";
+      exit(0);
+    }
+  }
+  std::cout << "Completed. Beginning Run ...\n\n";
+}
+//----------------------------------------------------------------------------------------------
 
-      if (event.empty()) {
-        std::cout << "No Event in CORSIKA File. Exiting.\n";
-        file.Close();
-        exit(0);
-      }
+//__Expand Space-Separated Paths and Wildcards into Files_______________________________________
+std::vector<std::string> _expand_paths(const std::string& paths) {
+  std::vector<std::string> tokens, out;
+  util::string::split(paths, tokens, " ");
+  for (const auto& token : tokens) {
+    if (token.empty())
+      continue;
+    TChain chain("sim");
+    chain.Add(token.c_str());
+    for (const auto element : *chain.GetListOfFiles())
+      out.push_back(element->GetTitle());
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Number of Showers in CORSIKA File___________________________________________________________
+Long64_t _count_showers(const std::string& path) {
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+  if (!file || file->IsZombie())
+    return 0LL;
+  const auto tree = dynamic_cast<TTree*>(file->Get("sim"));
+  return tree ? tree->GetEntries() : 0LL;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stream of Showers over One or More CORSIKA Files____________________________________________
+// showers are numbered across all files and split between worker threads either in contiguous
+// blocks or interleaved by thread ID, so the assignment only depends on the inputs and thread
+// count, and each thread reads its own showers through its own files and cache without locks
+class _shower_stream {
+public:
+  _shower_stream(const std::vector<std::string>& paths,
+                 const Long64_t cache_size,
+                 const bool interleave)
+      : _paths(paths), _cache_size(cache_size), _open_file(paths.size()), _current_file(0UL) {
+    _offsets.push_back(0ULL);
+    for (const auto& path : _paths)
+      _offsets.push_back(_offsets.back() + _count_showers(path));
+
+    const auto total = static_cast<std::size_t>(_offsets.back());
+    if (interleave) {
+      const auto slot = _thread_slot();
+      _index = slot.second;
+      _step = slot.first;
+      _end = total;
+    } else {
+      const auto range = _calculate_thread_range(total);
+      _index = range.first;
+      _step = 1UL;
+      _end = range.second;
+    }
+  }
+
+  std::size_t total() const {
+    return _offsets.back();
+  }
 
+  bool next(const Particle& origin,
+            CORSIKAConfig& config,
+            CORSIKAEvent& event) {
+    while (_index < _end) {
+      while (_index >= _offsets[_current_file + 1])
+        ++_current_file;
+      if (_open_file != _current_file) {
+        _open_file = _current_file;
+        _file.reset(new _shower_file(_paths[_current_file], _cache_size));
+        if (!_file->good())
+          std::cout << "[CORSIKA] No Showers in " << _paths[_current_file] << ". Skipping.\n";
+      }
+      const auto index = _index;
+      _index += _step;
+      if (_file->good()) {
+        config.event_id = index;
+        return _file->load(index - _offsets[_current_file], origin, config, event);
+      }
     }
-    std::cout << "Completed. Beginning Run ...\n\n";
+    return false;
   }
-  file.Close();
+
+private:
+  const std::vector<std::string> _paths;
+  const Long64_t _cache_size;
+  std::vector<std::size_t> _offsets;
+  std::unique_ptr<_shower_file> _file;
+  std::size_t _open_file, _current_file;
+  std::size_t _index, _step, _end;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Shower Stream of the Current Thread_________________________________________________________
+G4ThreadLocal _shower_stream* _stream = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Particle Whitelist for Specification________________________________________________________
+std::string _join_particles(const std::set<int>& particles) {
+  std::string out;
+  for (const auto id : particles)
+    out += (out.empty() ? "" : " ") + std::to_string(id);
+  return out.empty() ? "all" : out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Minimum Energies for Specification__________________________________________________________
+std::string _join_energies(const std::map<int, double>& energies) {
+  std::string out;
+  for (const auto& entry : energies)
+    out += (out.empty() ? "" : " ") + std::to_string(entry.first) + ":"
+         + Units::to_string(entry.second, Units::Energy, Units::EnergyString);
+  return out.empty() ? "none" : out;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -325,10 +580,28 @@ void _collect_source(const std::string& path,
 
 //__CORSIKA Reader Generator Constructor________________________________________________________
 CORSIKAReaderGenerator::CORSIKAReaderGenerator(const std::string& path)
-    : Generator("corsika_reader", "CORSIKA Reader Generator."), _last_event({}), _translation({0, 0}), _path(path) {
+    : Generator("corsika_reader", "CORSIKA Reader Generator."), _last_event({}), _translation({0, 0}), _path(path),
+      _dethin_cap(0UL), _dethin_radius(1*m), _dethin_angle(1*deg),
+      _streaming(false), _interleave(false), _shower_count(0UL), _tree_cache(32UL),
+      _cull_radius(0), _cull_center_loaded(false), _cull_center({0, 0}),
+      _cull_read(0UL), _culled_type(0UL), _culled_energy(0UL), _culled_footprint(0UL) {
   _read_file = CreateCommand<Command::StringArg>("read_file", "Read CORSIKA ROOT File.");
   _read_file->AvailableForStates(G4State_PreInit, G4State_Idle);
 
+  _stream_files = CreateCommand<Command::StringArg>("stream", "Stream All Showers from CORSIKA ROOT Files (Wildcards Allowed), One per Event.");
+  _stream_files->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _stream_files->SetParameterName("files", false);
+
+  _set_partition = CreateCommand<Command::StringArg>("partition", "Split Streamed Showers between Threads in Blocks or Interleaved by Thread ID.");
+  _set_partition->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_partition->SetParameterName("partition", false);
+  _set_partition->SetCandidates("block interleave");
+
+  _set_tree_cache = CreateCommand<Command::IntegerArg>("tree_cache", "Set TTreeCache Size in MB.");
+  _set_tree_cache->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_tree_cache->SetParameterName("size", false, false);
+  _set_tree_cache->SetRange("size >= 0");
+
   _set_event_id = CreateCommand<Command::IntegerArg>("event_id", "Set Shower ID to Simulate.");
   _set_event_id->AvailableForStates(G4State_PreInit, G4State_Idle);
   _set_event_id->SetParameterName("event", false, false);
@@ -340,23 +613,131 @@ CORSIKAReaderGenerator::CORSIKAReaderGenerator(const std::string& path)
   _set_max_radius->SetRange("radius >= 0");
   _set_max_radius->SetDefaultUnit("m");
   _set_max_radius->SetUnitCandidates("m cm");
+
+  _set_dethin = CreateCommand<Command::IntegerArg>("dethin", "Resample Thinned Particles into at most N Copies (0 to Keep Weights).");
+  _set_dethin->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_dethin->SetParameterName("cap", false, false);
+  _set_dethin->SetRange("cap >= 0");
+
+  _set_dethin_radius = CreateCommand<Command::DoubleUnitArg>("dethin_radius", "Set De-Thinning Position Spread Radius.");
+  _set_dethin_radius->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_dethin_radius->SetParameterName("radius", false, false);
+  _set_dethin_radius->SetRange("radius >= 0");
+  _set_dethin_radius->SetDefaultUnit("m");
+  _set_dethin_radius->SetUnitCandidates("m cm");
+
+  _set_dethin_angle = CreateCommand<Command::DoubleUnitArg>("dethin_angle", "Set De-Thinning Direction Spread Half-Angle.");
+  _set_dethin_angle->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_dethin_angle->SetParameterName("angle", false, false);
+  _set_dethin_angle->SetRange("angle >= 0");
+  _set_dethin_angle->SetDefaultUnit("deg");
+  _set_dethin_angle->SetUnitCandidates("deg rad mrad");
+
+  _set_cull_radius = CreateCommand<Command::DoubleUnitArg>("cull_radius", "Drop Particles Farther than Radius from the Detector after Translation (0 to Keep All).");
+  _set_cull_radius->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_cull_radius->SetParameterName("radius", false, false);
+  _set_cull_radius->SetRange("radius >= 0");
+  _set_cull_radius->SetDefaultUnit("m");
+  _set_cull_radius->SetUnitCandidates("m cm km");
+
+  _set_cull_energy = CreateCommand<Command::StringArg>("cull_energy", "Drop Particles below Kinetic Energy: <particle> <energy> <unit>.");
+  _set_cull_energy->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_cull_energy->SetParameterName("cut", false);
+
+  _set_cull_particles = CreateCommand<Command::StringArg>("cull_particles", "Keep only the Listed Particles.");
+  _set_cull_particles->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _set_cull_particles->SetParameterName("particles", false);
+
+  _clear_culls = CreateCommand<Command::NoArg>("cull_clear", "Remove All Read-Time Culls.");
+  _clear_culls->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Generate Initial Particles__________________________________________________________________
 void CORSIKAReaderGenerator::GeneratePrimaryVertex(G4Event* event) {
   _last_event.clear();
+  if (_streaming) {
+    if (!_stream || !_stream->next(_particle, _config, _event)) {
+      std::cout << "\n[ERROR] CORSIKA Stream Exhausted. Aborting Run.\n";
+      _event.clear();
+      G4RunManager::GetRunManager()->AbortRun(true);
+      return;
+    }
+    ++_shower_count;
+  }
+
   _translation = _random_translation(_config.max_radius);
   for (std::size_t i{}; i < _event.size(); ++i) {
     auto particle = _event[i];
+    if (Cull(particle))
+      continue;
     particle.x -= _translation.first;
     particle.y -= _translation.second;
-    if (std::abs(particle.x) >= Construction::WorldLength / 2.0L
-        || std::abs(particle.y) >= Construction::WorldLength / 2.0L)
+    const auto weight = _event.weight[i];
+
+    // a thinned particle of weight w is replaced by n = min(round(w), cap) copies of weight w / n
+    const auto copies = _dethin_cap && weight > 1.0
+      ? std::min(std::max<std::size_t>(std::lround(weight), 1UL), _dethin_cap) : 1UL;
+    if (CullFootprint(particle, copies > 1 ? _dethin_radius : 0)) {
+      _culled_footprint += copies;
       continue;
-    _last_event.push_back(particle);
-    AddParticle(particle, *event);
+    }
+    for (std::size_t copy{}; copy < copies; ++copy) {
+      const auto current = copies > 1 ? _spread(particle, _dethin_radius, _dethin_angle) : particle;
+      if (copies > 1 && CullFootprint(current)) {
+        ++_culled_footprint;
+        continue;
+      }
+      if (std::abs(current.x) >= Construction::WorldLength / 2.0L
+          || std::abs(current.y) >= Construction::WorldLength / 2.0L)
+        continue;
+      GenParticle gen_particle(current);
+      gen_particle.weight = weight / copies;
+      _last_event.push_back(gen_particle);
+      AddParticle(current, *event, gen_particle.weight);
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Particle Type or Energy is Culled__________________________________________________
+// culls are applied to the particles as read, before any translation, copies or primaries
+bool CORSIKAReaderGenerator::Cull(const Particle& particle) {
+  ++_cull_read;
+  if (!_cull_particles.empty() && !_cull_particles.count(particle.id)) {
+    ++_culled_type;
+    return true;
+  }
+  if (!_cull_energy.empty()) {
+    const auto search = _cull_energy.find(particle.id);
+    if (search != _cull_energy.end() && particle.ke() < search->second) {
+      ++_culled_energy;
+      return true;
+    }
   }
+  return false;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Translated Particle is outside the Footprint_______________________________________
+// the footprint is a disk around the detector center in the observation plane, grown by the
+// spread of any de-thinned copies so a particle is only culled if none of its copies can land
+bool CORSIKAReaderGenerator::CullFootprint(const Particle& particle,
+                                           const double spread) {
+  if (_cull_radius <= 0)
+    return false;
+  if (!_cull_center_loaded) {
+    _cull_center_loaded = true;
+    G4ThreeVector min, max;
+    if (Construction::GlobalExtent(Construction::Builder::GetDetectorName(), min, max))
+      _cull_center = {0.5 * (min.x() + max.x()), 0.5 * (min.y() + max.y())};
+    else
+      std::cout << "[CORSIKA] Detector Not Found. Footprint Centered on the World.\n";
+  }
+  const auto radius = _cull_radius + spread;
+  const auto dx = particle.x - _cull_center.first;
+  const auto dy = particle.y - _cull_center.second;
+  return dx * dx + dy * dy > radius * radius;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -371,10 +752,60 @@ void CORSIKAReaderGenerator::SetNewValue(G4UIcommand* command,
                                          G4String value) {
   if (command == _read_file) {
     SetFile(value);
+  } else if (command == _stream_files) {
+    SetStream(value);
+  } else if (command == _set_partition) {
+    _interleave = value == "interleave";
+    if (_streaming)
+      SetStream(_path);
+  } else if (command == _set_tree_cache) {
+    _tree_cache = std::max(_set_tree_cache->GetNewIntValue(value), 0);
   } else if (command == _set_event_id) {
     _config.event_id = _set_event_id->GetNewIntValue(value);
   } else if (command == _set_max_radius) {
     _config.max_radius = _set_max_radius->GetNewDoubleValue(value);
+  } else if (command == _set_dethin) {
+    _dethin_cap = std::max(_set_dethin->GetNewIntValue(value), 0);
+  } else if (command == _set_dethin_radius) {
+    _dethin_radius = _set_dethin_radius->GetNewDoubleValue(value);
+  } else if (command == _set_dethin_angle) {
+    _dethin_angle = _set_dethin_angle->GetNewDoubleValue(value);
+  } else if (command == _set_cull_radius) {
+    _cull_radius = _set_cull_radius->GetNewDoubleValue(value);
+  } else if (command == _set_cull_energy) {
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ");
+    tokens.erase(std::remove(tokens.begin(), tokens.end(), ""), tokens.end());
+    if (tokens.size() != 3UL) {
+      std::cout << "[CORSIKA] Expected: <particle> <energy> <unit>\n";
+      return;
+    }
+    const auto particle = G4ParticleTable::GetParticleTable()->FindParticle(tokens[0]);
+    if (!particle) {
+      std::cout << "[CORSIKA] Unknown Particle \"" << tokens[0] << "\".\n";
+      return;
+    }
+    try {
+      _cull_energy[particle->GetPDGEncoding()] = std::stod(tokens[1]) * G4UIcommand::ValueOf(tokens[2].c_str());
+    } catch (...) {
+      std::cout << "[CORSIKA] Invalid Energy Cull \"" << value << "\".\n";
+    }
+  } else if (command == _set_cull_particles) {
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ,");
+    for (const auto& name : tokens) {
+      if (name.empty())
+        continue;
+      const auto particle = G4ParticleTable::GetParticleTable()->FindParticle(name);
+      if (particle)
+        _cull_particles.insert(particle->GetPDGEncoding());
+      else
+        std::cout << "[CORSIKA] Unknown Particle \"" << name << "\".\n";
+    }
+  } else if (command == _clear_culls) {
+    _cull_radius = 0;
+    _cull_energy.clear();
+    _cull_particles.clear();
   } else {
     Generator::SetNewValue(command, value);
   }
@@ -384,10 +815,29 @@ void CORSIKAReaderGenerator::SetNewValue(G4UIcommand* command,
 //__Set Pythia Object from Settings_____________________________________________________________
 void CORSIKAReaderGenerator::SetFile(const std::string& path) {
   _path = path;
+  _streaming = false;
+  _cull_read = _culled_type = _culled_energy = _culled_footprint = 0UL;
   if (G4Threading::IsWorkerThread()) {
     G4AutoLock lock(&_mutex);
     _event.clear();
-    _collect_source(_path, _particle, _config, _event);
+    _collect_source(_path, _tree_cache << 20, _particle, _config, _event);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stream Showers from Files___________________________________________________________________
+void CORSIKAReaderGenerator::SetStream(const std::string& paths) {
+  _path = paths;
+  _streaming = true;
+  _shower_count = 0UL;
+  _cull_read = _culled_type = _culled_energy = _culled_footprint = 0UL;
+  if (G4Threading::IsWorkerThread()) {
+    G4AutoLock lock(&_mutex);
+    delete _stream;
+    const auto files = _expand_paths(_path);
+    _stream = new _shower_stream(files, _tree_cache << 20, _interleave);
+    std::cout << "\n\nStreaming " << _stream->total() << " Showers from " << files.size()
+              << " CORSIKA Files (" << (_interleave ? "Interleaved" : "Block") << " Partition) ...\n\n";
   }
 }
 //----------------------------------------------------------------------------------------------
@@ -397,6 +847,10 @@ const Analysis::SimSettingList CORSIKAReaderGenerator::GetSpecification() const
   return Analysis::Settings(SimSettingPrefix,
     "",                  _name,
     "_INPUT_FILE",       _path,
+    "_STREAM",           _streaming ? "true" : "false",
+    "_PARTITION",        _interleave ? "interleave" : "block",
+    "_SHOWERS",          std::to_string(_streaming ? _shower_count : 1UL),
+    "_TREE_CACHE",       std::to_string(_tree_cache) + " MB",
     "_EVENT_ID",         std::to_string(_config.event_id),
     "_PRIMARY_ENERGY",   std::to_string(_config.energy),
     "_THETA",            std::to_string(_config.theta),
@@ -413,7 +867,17 @@ const Analysis::SimSettingList CORSIKAReaderGenerator::GetSpecification() const
     "_AZIMUTH_MAX",      std::to_string(_config.azimuth_max),
     "_ZENITH_MIN",       std::to_string(_config.zenith_min),
     "_ZENITH_MAX",       std::to_string(_config.zenith_max),
-    "_MAX_SHIFT_RADIUS", Units::to_string(_config.max_radius, Units::Length, Units::LengthString)
+    "_MAX_SHIFT_RADIUS", Units::to_string(_config.max_radius, Units::Length, Units::LengthString),
+    "_DETHIN_CAP",       std::to_string(_dethin_cap),
+    "_DETHIN_RADIUS",    Units::to_string(_dethin_radius, Units::Length, Units::LengthString),
+    "_DETHIN_ANGLE",     std::to_string(_dethin_angle / deg) + " deg",
+    "_CULL_RADIUS",      Units::to_string(_cull_radius, Units::Length, Units::LengthString),
+    "_CULL_ENERGY",      _join_energies(_cull_energy),
+    "_CULL_PARTICLES",   _join_particles(_cull_particles),
+    "_CULL_READ",        std::to_string(_cull_read),
+    "_CULLED_TYPE",      std::to_string(_culled_type),
+    "_CULLED_ENERGY",    std::to_string(_culled_energy),
+    "_CULLED_FOOTPRINT", std::to_string(_culled_footprint)
   );
 }
 //----------------------------------------------------------------------------------------------
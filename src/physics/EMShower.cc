@@ -0,0 +1,336 @@
+/*
+ * src/physics/EMShower.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/EMShower.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+
+#include <G4AutoDelete.hh>
+#include <G4AutoLock.hh>
+#include <G4DynamicParticle.hh>
+#include <G4Electron.hh>
+#include <G4FastStep.hh>
+#include <G4FastTrack.hh>
+#include <G4Gamma.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4Positron.hh>
+#include <G4RandomDirection.hh>
+#include <G4RegionStore.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4UnitsTable.hh>
+#include <Randomize.hh>
+#include <tls.hh>
+
+#include <TFile.h>
+#include <TH1D.h>
+
+namespace MATHUSLA { namespace MU {
+
+namespace EMShower { ///////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__EM Shower State_____________________________________________________________________________
+bool _enabled = false;
+bool _active = true;
+double _emin = 100*MeV;
+int _spots = 100;
+Messenger* _messenger = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Shower Counters_____________________________________________________________________________
+std::atomic<std::size_t> _shower_count{};
+double _shower_energy = 0;
+//----------------------------------------------------------------------------------------------
+
+//__Deposit Profiles of Parameterised Showers___________________________________________________
+TH1D* _longitudinal = nullptr;
+TH1D* _lateral = nullptr;
+G4Mutex _mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Per-Thread Attachment_______________________________________________________________________
+G4ThreadLocal bool _attached = false;
+//----------------------------------------------------------------------------------------------
+
+//__Spot of Parameterised Deposit (Depth in X0, Radius in Moliere Radii)________________________
+struct _spot {
+  double depth, radius;
+};
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Model Constructor___________________________________________________________________________
+Model::Model(const G4String& name,
+             G4Region* envelope) : G4VFastSimulationModel(name, envelope), _current(nullptr) {}
+//----------------------------------------------------------------------------------------------
+
+//__Model Applies to Electrons, Positrons and Photons___________________________________________
+G4bool Model::IsApplicable(const G4ParticleDefinition& particle) {
+  return &particle == G4Electron::Definition()
+      || &particle == G4Positron::Definition()
+      || &particle == G4Gamma::Definition();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Trigger on Contained Showers above Threshold________________________________________________
+// a shower is only parameterised when the envelope holds its 95% longitudinal and lateral
+// containment, so the energy booked at the entry point never belongs to a scintillator
+G4bool Model::ModelTrigger(const G4FastTrack& fast_track) {
+  const auto track = fast_track.GetPrimaryTrack();
+  const auto energy = track->GetKineticEnergy();
+  if (!_active || energy < _emin)
+    return false;
+
+  _current = &_medium(track->GetMaterial());
+  const auto solid = fast_track.GetEnvelopeSolid();
+  const auto position = fast_track.GetPrimaryTrackLocalPosition();
+  const auto depth = _containment_depth(*_current, energy, track->GetDefinition() == G4Gamma::Definition());
+  return solid->DistanceToOut(position, fast_track.GetPrimaryTrackLocalDirection())
+           >= depth * _current->radiation_length
+      && solid->DistanceToOut(position) >= 2.0 * _current->moliere_radius;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Deposit Shower Energy Along Parameterised Profiles__________________________________________
+void Model::DoIt(const G4FastTrack& fast_track,
+                 G4FastStep& step) {
+  const auto track = fast_track.GetPrimaryTrack();
+  const auto photon = track->GetDefinition() == G4Gamma::Definition();
+  const auto energy = track->GetKineticEnergy();
+
+  const auto start = _profile(*_current, energy, photon, 0.0);
+  std::vector<_spot> spots;
+  spots.reserve(_spots);
+  for (int i{}; i < _spots; ++i) {
+    const auto depth = CLHEP::RandGamma::shoot(start.alpha, start.beta);
+    const auto profile = _profile(*_current, energy, photon, depth / start.t_max);
+    const auto radius = G4UniformRand() < profile.core_fraction ? profile.core_radius
+                                                                : profile.tail_radius;
+    const auto u = std::min(G4UniformRand(), 0.999);
+    spots.push_back({depth, radius * std::sqrt(u / (1.0 - u))});
+  }
+
+  step.KillPrimaryTrack();
+  step.ProposePrimaryTrackPathLength(0.0);
+  step.ProposeTotalEnergyDeposited(energy);
+
+  // positrons annihilate at rest near shower maximum, the photons are left to full tracking
+  if (track->GetDefinition() == G4Positron::Definition()) {
+    const auto depth = start.t_max * _current->radiation_length;
+    const auto position = track->GetPosition() + depth * track->GetMomentumDirection();
+    const auto time = track->GetGlobalTime() + depth / c_light;
+    const auto direction = G4RandomDirection();
+    step.SetNumberOfSecondaryTracks(2);
+    for (const auto& sign : {1.0, -1.0})
+      step.CreateSecondaryTrack(G4DynamicParticle(G4Gamma::Definition(), sign * direction, electron_mass_c2),
+                                position, time, false);
+  }
+
+  ++_shower_count;
+  const auto spot_energy = energy / _spots;
+  G4AutoLock lock(&_mutex);
+  _shower_energy += energy;
+  for (const auto& spot : spots) {
+    _longitudinal->Fill(spot.depth, spot_energy / MeV);
+    _lateral->Fill(spot.radius, spot_energy / MeV);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Radiation Length, Moliere Radius and Critical Energy of Material____________________________
+const Model::Medium& Model::_medium(const G4Material* material) {
+  const auto search = _media.find(material);
+  if (search != _media.end())
+    return search->second;
+
+  const auto fractions = material->GetFractionVector();
+  double z = 0;
+  for (std::size_t i{}; i < material->GetNumberOfElements(); ++i)
+    z += fractions[i] * material->GetElement(i)->GetZ();
+
+  Medium medium;
+  medium.z = z;
+  medium.radiation_length = material->GetRadlen();
+  medium.critical_energy = 610.0*MeV / (z + 1.24);
+  medium.moliere_radius = 21.2052*MeV * medium.radiation_length / medium.critical_energy;
+  return _media.emplace(material, medium).first->second;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Homogeneous Shower Profile (Grindhammer-Peters) at Relative Depth tau = t / t_max___________
+Model::Profile Model::_profile(const Medium& medium,
+                               const double energy,
+                               const bool photon,
+                               const double tau) const {
+  const auto log_y = std::log(energy / medium.critical_energy);
+  const auto log_e = std::log(energy / GeV);
+  const auto z = medium.z;
+
+  Profile out;
+  out.t_max = std::max(log_y - 0.858 + (photon ? 1.0 : 0.0), 0.5);
+  out.alpha = std::max(0.21 + (0.492 + 2.38 / z) * log_y, 1.5);
+  out.beta = (out.alpha - 1.0) / out.t_max;
+
+  out.core_radius = (0.0251 + 0.00319 * log_e) + (0.1162 - 0.000381 * z) * tau;
+  out.tail_radius = (0.659 - 0.00309 * z)
+                  * (std::exp(-2.59 * (tau - 0.645)) + std::exp((0.3585 + 0.0421 * log_e) * (tau - 0.645)));
+  const auto x = ((0.401 + 0.00187 * z) - tau) / (1.313 - 0.0686 * log_e);
+  out.core_fraction = std::min(std::max((0.2632 - 0.00094 * z) * std::exp(x - std::exp(x)), 0.0), 1.0);
+  out.core_radius = std::max(out.core_radius, 0.0);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Depth for 95% Longitudinal Containment in Radiation Lengths_________________________________
+double Model::_containment_depth(const Medium& medium,
+                                 const double energy,
+                                 const bool photon) const {
+  return _profile(medium, energy, photon, 0.0).t_max + 0.08 * medium.z + 9.6;
+}
+//----------------------------------------------------------------------------------------------
+
+//__EM Shower Messenger Directory Path__________________________________________________________
+const std::string Messenger::MessengerDirectory = "/fast/shower/";
+//----------------------------------------------------------------------------------------------
+
+//__EM Shower Messenger Constructor_____________________________________________________________
+Messenger::Messenger() : G4UImessenger(MessengerDirectory, "Parameterised EM Showers in Passive Material.") {
+  _active = CreateCommand<Command::BoolArg>("active",
+    "Parameterise EM Showers (false for Full Simulation).");
+  _active->SetParameterName("active", false);
+  _active->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _active->SetToBeBroadcasted(false);
+
+  _emin = CreateCommand<Command::DoubleUnitArg>("emin",
+    "Set Minimum Kinetic Energy for Shower Parameterisation.");
+  _emin->SetParameterName("emin", false, false);
+  _emin->SetRange("emin >= 0");
+  _emin->SetDefaultUnit("MeV");
+  _emin->SetUnitCandidates("keV MeV GeV");
+  _emin->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _emin->SetToBeBroadcasted(false);
+
+  _spots = CreateCommand<Command::IntegerArg>("spots",
+    "Set Number of Energy Spots Sampled per Shower.");
+  _spots->SetParameterName("spots", false);
+  _spots->SetRange("spots > 0");
+  _spots->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _spots->SetToBeBroadcasted(false);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print EM Shower Settings.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__EM Shower Messenger Set New Value___________________________________________________________
+void Messenger::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _active) {
+    EMShower::_active = _active->GetNewBoolValue(value);
+  } else if (command == _emin) {
+    EMShower::_emin = _emin->GetNewDoubleValue(value);
+  } else if (command == _spots) {
+    EMShower::_spots = _spots->GetNewIntValue(value);
+  } else if (command == _print) {
+    std::cout << "EM Showers: " << (EMShower::_active ? "parameterised" : "full")
+              << " | emin: " << G4BestUnit(EMShower::_emin, "Energy")
+              << " | spots: " << EMShower::_spots << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable EM Shower Parameterisation___________________________________________________________
+void Enable() {
+  if (_enabled)
+    return;
+  _longitudinal = new TH1D("em_shower_longitudinal",
+    "Parameterised Longitudinal Deposit;t [X_{0}];E [MeV]", 60, 0, 30);
+  _lateral = new TH1D("em_shower_lateral",
+    "Parameterised Lateral Deposit;r [R_{M}];E [MeV]", 100, 0, 5);
+  for (auto histogram : {_longitudinal, _lateral})
+    histogram->SetDirectory(nullptr);
+  _messenger = new Messenger;
+  _enabled = true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if EM Shower Parameterisation is Enabled______________________________________________
+bool IsEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attach Model to Passive Regions (Once per Thread)___________________________________________
+void Attach(const std::vector<std::string>& regions) {
+  if (!_enabled || _attached)
+    return;
+  _attached = true;
+  for (const auto& name : regions) {
+    const auto region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (!region) {
+      std::cout << "[EMShower] Region \"" << name << "\" Not Found. Skipping.\n";
+      continue;
+    }
+    auto model = new Model("EMShower" + name, region);
+    G4AutoDelete::Register(model);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Number of Parameterised Showers_________________________________________________________
+std::size_t ShowerCount() {
+  return _shower_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Energy Deposited by Parameterised Showers_______________________________________________
+double ShowerEnergy() {
+  G4AutoLock lock(&_mutex);
+  return _shower_energy;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Shower Counters_______________________________________________________________________
+void ResetCounters() {
+  _shower_count = 0UL;
+  G4AutoLock lock(&_mutex);
+  _shower_energy = 0;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Deposit Profiles and Reset____________________________________________________________
+void Save(TFile* file) {
+  if (!_enabled || !file)
+    return;
+  G4AutoLock lock(&_mutex);
+  file->cd();
+  for (auto histogram : {_longitudinal, _lateral}) {
+    histogram->Write();
+    histogram->Reset();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace EMShower */ /////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
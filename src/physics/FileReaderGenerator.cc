@@ -1,25 +1,337 @@
 #include "physics/FileReaderGenerator.hh"
 
 #include "physics/Particle.hh"
+#include "physics/Acceptance.hh"
 #include "analysis.hh"
 
 #include <G4AutoLock.hh>
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
 #include <string>
 #include <cstddef>
-#include <fstream>
-#include <limits>
-#include <ios>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
 
 namespace MATHUSLA { namespace MU { namespace Physics {
 
+// A particle parameters file mapped read-only into memory and shared by every worker thread.
+// Text files hold one particle per event, one "id x y z px py pz" line each. Opening one only
+// records where each particle line starts; lines are parsed when an event needs them. Binary
+// files, recognized by their magic bytes, carry their own event index and are read in place:
+//
+//   char[8]        magic "MUPARTIC"
+//   uint32         format version
+//   uint32         particle record size in bytes
+//   uint64         number of events N
+//   uint64         number of particles P
+//   uint64[N + 1]  index of the first particle of each event, ending with P
+//   P records      int32 id, double x y z t px py pz weight, packed and little-endian
+//
+// The event cursor is a single atomic counter shared by all threads.
+class ParticleFile {
+public:
+  explicit ParticleFile(const std::string &path);
+  ~ParticleFile();
+
+  ParticleFile(const ParticleFile &) = delete;
+  ParticleFile &operator=(const ParticleFile &) = delete;
+
+  bool binary() const { return _binary; }
+  std::size_t size() const { return _binary ? _events : _offsets.size(); }
+  void read(std::size_t index, std::vector<Particle> &particles, std::vector<double> &weights) const;
+
+  std::atomic<std::size_t> cursor{0};
+
+private:
+  void index_text();
+  void index_binary();
+  Particle parse_line(std::size_t index) const;
+
+  const char *_data = nullptr;
+  std::size_t _length = 0;
+  bool _binary = false;
+  std::uint64_t _events = 0;
+  const char *_event_index = nullptr;
+  const char *_records = nullptr;
+  std::vector<std::size_t> _offsets;
+};
+
 namespace {
 
 G4Mutex mutex = G4MUTEX_INITIALIZER;
 
+// Files are shared between the generators of all worker threads, which each receive the
+// pathname command, so the file is only mapped and indexed once.
+std::map<std::string, std::weak_ptr<ParticleFile>> open_files;
+
+constexpr char binary_magic[8] = {'M', 'U', 'P', 'A', 'R', 'T', 'I', 'C'};
+constexpr std::uint32_t binary_version = 1;
+constexpr std::size_t binary_header_length = 32;
+constexpr std::size_t binary_record_length = sizeof(std::int32_t) + 8 * sizeof(double);
+
+// Binary files are little-endian, so values are byte-swapped on big-endian hosts.
+template <class T>
+T to_little_endian(T value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  std::reverse(bytes, bytes + sizeof(T));
+  std::memcpy(&value, bytes, sizeof(T));
+#endif
+  return value;
+}
+
+template <class T>
+T load(const char *data) {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return to_little_endian(value);
+}
+
+template <class T>
+void store(std::ostream &output, const T value) {
+  const auto little_endian = to_little_endian(value);
+  output.write(reinterpret_cast<const char *>(&little_endian), sizeof(T));
+}
+
+// Chunks smaller than this are not worth a thread of their own.
+constexpr std::size_t min_chunk_length = 1UL << 24;
+
+bool is_blank(const char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Start of the first line beginning at or after position.
+std::size_t line_start(const char *data, std::size_t length, std::size_t position) {
+  if (position == 0 || position >= length)
+    return std::min(position, length);
+  const auto newline = static_cast<const char *>(std::memchr(data + position - 1, '\n', length - position + 1));
+  return newline ? newline - data + 1 : length;
+}
+
+// Offsets of the particle lines starting in [begin, end), skipping blank and comment lines.
+std::vector<std::size_t> index_lines(const char *data, std::size_t length,
+                                     std::size_t begin, std::size_t end) {
+  std::vector<std::size_t> out;
+  auto position = line_start(data, length, begin);
+  while (position < end) {
+    const auto newline = static_cast<const char *>(std::memchr(data + position, '\n', length - position));
+    const std::size_t line_end = newline ? newline - data : length;
+    while (position < line_end && is_blank(data[position]))
+      ++position;
+    if (position < line_end && data[position] != '#')
+      out.push_back(position);
+    position = line_end + 1;
+  }
+  return out;
+}
+
+template <class T>
+const char *parse_value(const char *first, const char *last, T &value) {
+  while (first != last && is_blank(*first))
+    ++first;
+  if (first != last && *first == '+')
+    ++first;
+  const auto result = std::from_chars(first, last, value);
+  if (result.ec != std::errc()) {
+    throw std::runtime_error("Unable to parse particle parameters file");
+  }
+  return result.ptr;
+}
+
+std::shared_ptr<ParticleFile> open_file(const std::string &path) {
+  G4AutoLock lock(mutex);
+  auto &entry = open_files[path];
+  auto file = entry.lock();
+  if ( ! file) {
+    file = std::make_shared<ParticleFile>(path);
+    entry = file;
+  }
+  return file;
+}
+
 } // anonymous namespace
 
+ParticleFile::ParticleFile(const std::string &path) {
+  const auto descriptor = ::open(path.c_str(), O_RDONLY);
+  struct stat status;
+  if (descriptor < 0 || ::fstat(descriptor, &status) != 0) {
+    if (descriptor >= 0)
+      ::close(descriptor);
+    throw std::runtime_error("Unable to read particle parameters file");
+  }
+  _length = status.st_size;
+  if (_length) {
+    const auto mapped = ::mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapped == MAP_FAILED) {
+      ::close(descriptor);
+      throw std::runtime_error("Unable to read particle parameters file");
+    }
+    _data = static_cast<const char *>(mapped);
+    ::madvise(const_cast<char *>(_data), _length, MADV_SEQUENTIAL);
+  }
+  ::close(descriptor);
+
+  _binary = _length >= sizeof(binary_magic) && std::memcmp(_data, binary_magic, sizeof(binary_magic)) == 0;
+  if (_binary) {
+    index_binary();
+  } else {
+    index_text();
+  }
+}
+
+ParticleFile::~ParticleFile() {
+  if (_data)
+    ::munmap(const_cast<char *>(_data), _length);
+}
+
+void ParticleFile::index_binary() {
+  const auto fail = [&](const std::string &reason) {
+    ::munmap(const_cast<char *>(_data), _length);
+    throw std::runtime_error("Invalid binary particle parameters file: " + reason);
+  };
+  if (_length < binary_header_length)
+    fail("truncated header");
+  if (load<std::uint32_t>(_data + 8) != binary_version)
+    fail("unsupported version");
+  if (load<std::uint32_t>(_data + 12) != binary_record_length)
+    fail("unexpected record size");
+  _events = load<std::uint64_t>(_data + 16);
+  const auto particles = load<std::uint64_t>(_data + 24);
+  if (_events >= (_length - binary_header_length) / sizeof(std::uint64_t))
+    fail("truncated event index");
+  const auto header_length = binary_header_length + (_events + 1) * sizeof(std::uint64_t);
+  if (particles > (_length - header_length) / binary_record_length)
+    fail("truncated records");
+  _event_index = _data + binary_header_length;
+  _records = _data + header_length;
+  if (load<std::uint64_t>(_records - sizeof(std::uint64_t)) != particles)
+    fail("inconsistent event index");
+}
+
+void ParticleFile::index_text() {
+  // the index is built in one pass over contiguous chunks, one thread each, and joined in order
+  const std::size_t hardware = std::max(1U, std::thread::hardware_concurrency());
+  const auto chunks = std::max<std::size_t>(1UL, std::min(hardware, _length / min_chunk_length));
+  std::vector<std::vector<std::size_t>> chunk_offsets(chunks);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < chunks; ++i) {
+    threads.emplace_back([&, i] {
+      chunk_offsets[i] = index_lines(_data, _length, _length * i / chunks, _length * (i + 1) / chunks);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (const auto &offsets : chunk_offsets)
+    _offsets.insert(_offsets.end(), offsets.begin(), offsets.end());
+}
+
+Particle ParticleFile::parse_line(std::size_t index) const {
+  const auto first = _data + _offsets.at(index);
+  const auto newline = static_cast<const char *>(std::memchr(first, '\n', _data + _length - first));
+  const auto last = newline ? newline : _data + _length;
+
+  Particle particle{};
+  auto position = parse_value(first, last, particle.id);
+  position = parse_value(position, last, particle.x);
+  position = parse_value(position, last, particle.y);
+  position = parse_value(position, last, particle.z);
+  position = parse_value(position, last, particle.px);
+  position = parse_value(position, last, particle.py);
+  parse_value(position, last, particle.pz);
+  return particle;
+}
+
+void ParticleFile::read(std::size_t index, std::vector<Particle> &particles, std::vector<double> &weights) const {
+  particles.clear();
+  weights.clear();
+  if ( ! _binary) {
+    particles.push_back(parse_line(index));
+    weights.push_back(1.0);
+    return;
+  }
+  if (index >= _events) {
+    throw std::out_of_range("Particle parameters file exhausted");
+  }
+  const auto first = load<std::uint64_t>(_event_index + index * sizeof(std::uint64_t));
+  const auto last = load<std::uint64_t>(_event_index + (index + 1) * sizeof(std::uint64_t));
+  if (first > last || last > load<std::uint64_t>(_data + 24)) {
+    throw std::runtime_error("Invalid binary particle parameters file: inconsistent event index");
+  }
+  for (auto record = _records + first * binary_record_length; record != _records + last * binary_record_length;
+       record += binary_record_length) {
+    Particle particle{};
+    particle.id = load<std::int32_t>(record);
+    const auto values = record + sizeof(std::int32_t);
+    particle.x  = load<double>(values);
+    particle.y  = load<double>(values + 1 * sizeof(double));
+    particle.z  = load<double>(values + 2 * sizeof(double));
+    particle.t  = load<double>(values + 3 * sizeof(double));
+    particle.px = load<double>(values + 4 * sizeof(double));
+    particle.py = load<double>(values + 5 * sizeof(double));
+    particle.pz = load<double>(values + 6 * sizeof(double));
+    particles.push_back(particle);
+    weights.push_back(load<double>(values + 7 * sizeof(double)));
+  }
+}
+
+std::size_t ConvertParticleFile(const std::string &input, const std::string &output) {
+  const ParticleFile file(input);
+  std::ofstream stream(output, std::ios::binary | std::ios::trunc);
+  if ( ! stream) {
+    throw std::runtime_error("Unable to write binary particle parameters file");
+  }
+
+  // the event index is written after the records, once the particle counts are known
+  const std::uint64_t events = file.size();
+  std::vector<std::uint64_t> event_index{0};
+  event_index.reserve(events + 1);
+  stream.write(binary_magic, sizeof(binary_magic));
+  store(stream, binary_version);
+  store(stream, static_cast<std::uint32_t>(binary_record_length));
+  store(stream, events);
+  store(stream, std::uint64_t{0});
+  stream.seekp((events + 1) * sizeof(std::uint64_t), std::ios::cur);
+
+  std::vector<Particle> particles;
+  std::vector<double> weights;
+  for (std::size_t index = 0; index < events; ++index) {
+    file.read(index, particles, weights);
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+      const auto &particle = particles[i];
+      store(stream, static_cast<std::int32_t>(particle.id));
+      for (const double value : {particle.x, particle.y, particle.z, particle.t,
+                                 particle.px, particle.py, particle.pz, weights[i]}) {
+        store(stream, value);
+      }
+    }
+    event_index.push_back(event_index.back() + particles.size());
+  }
+
+  stream.seekp(24);
+  store(stream, event_index.back());
+  for (const auto first : event_index) {
+    store(stream, first);
+  }
+  if ( ! stream) {
+    throw std::runtime_error("Unable to write binary particle parameters file");
+  }
+  return events;
+}
+
 FileReaderGenerator::FileReaderGenerator(const std::string &name,
                                          const std::string &description)
     : Generator(name, description, {}) {
@@ -27,46 +339,24 @@ FileReaderGenerator::FileReaderGenerator(const std::string &name,
 }
 
 void FileReaderGenerator::GeneratePrimaryVertex(G4Event *event) {
-  std::size_t particle_parameters_index = _particle_parameters.size();
-  {
-    G4AutoLock lock(mutex);
-    particle_parameters_index = _event_counter;
-    ++_event_counter;
+  if ( ! _particle_file) {
+    throw std::runtime_error("No particle parameters file");
+  }
+  const auto index = _particle_file->cursor.fetch_add(1, std::memory_order_relaxed);
+  if (index >= _particle_file->size()) {
+    throw std::out_of_range("Particle parameters file exhausted");
+  }
+  _particle_file->read(index, _event_particles, _event_weights);
+  Acceptance::Select(_event_particles, _event_keep);
+  for (std::size_t i = 0; i < _event_particles.size(); ++i) {
+    if (_event_keep[i])
+      AddParticle(_event_particles[i], *event, _event_weights[i]);
   }
-  AddParticle(_particle_parameters.at(particle_parameters_index), *event);
 }
 
 void FileReaderGenerator::SetNewValue(G4UIcommand *command, G4String value) {
   if (command == _ui_pathname) {
-    std::ifstream input_stream(value);
-    while (input_stream) {
-      const auto next_char = input_stream.peek();
-      if (next_char == std::ifstream::traits_type::eof()) {
-              break;
-      }
-      if (next_char == ' ' || next_char == '\t' || next_char == '\r' || next_char == '\n') {
-              input_stream.ignore();
-              continue;
-      }
-      if (next_char == '#') {
-              input_stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-              continue;
-      }
-      _particle_parameters.emplace_back();
-      auto &new_parameters = _particle_parameters.back();
-      if ( ! (input_stream >> new_parameters.id
-                           >> new_parameters.x
-                           >> new_parameters.y
-                           >> new_parameters.z
-                           >> new_parameters.px
-                           >> new_parameters.py
-                           >> new_parameters.pz)) {
-        throw std::runtime_error("Unable to parse particle parameters file");
-      }
-    }
-    if ( ! input_stream) {
-      throw std::runtime_error("Unable to read particle parameters file");
-    }
+    _particle_file = open_file(value);
   } else {
     Generator::SetNewValue(command, value);
   }
@@ -76,14 +366,18 @@ std::ostream &FileReaderGenerator::Print(std::ostream &os) const {
   os << "Generator Info:\n  "
      << "Name:        " << _name                           << "\n  "
      << "Description: " << _description                    << "\n  "
-     << "Pathname:    " << _ui_pathname->GetCurrentValue() << "\n  ";
+     << "Pathname:    " << _ui_pathname->GetCurrentValue() << "\n  "
+     << "Format:      " << (_particle_file && _particle_file->binary() ? "binary" : "text") << "\n  "
+     << "Events:      " << (_particle_file ? _particle_file->size() : 0) << "\n  ";
   return os;
 }
 
 const Analysis::SimSettingList FileReaderGenerator::GetSpecification() const {
   return Analysis::Settings(SimSettingPrefix,
     "",         _name,
-    "_PATHNAME",  _ui_pathname->GetCurrentValue());
+    "_PATHNAME",  _ui_pathname->GetCurrentValue(),
+    "_FORMAT",    _particle_file && _particle_file->binary() ? "binary" : "text",
+    "_EVENTS",    std::to_string(_particle_file ? _particle_file->size() : 0));
 }
 
 void FileReaderGenerator::GenerateCommands() {
@@ -8,6 +8,7 @@
 #include <Randomize.hh>
 #include <G4ParticleTable.hh>
 
+#include "physics/Acceptance.hh"
 #include "physics/Units.hh"
 #include "tracking.hh"
 
@@ -110,7 +111,8 @@ void Generator::GenerateCommands() {
 
 //__Generate Initial Particles__________________________________________________________________
 void Generator::GeneratePrimaryVertex(G4Event* event) {
-  AddParticle(_particle, *event);
+  if (Acceptance::Select(_particle))
+    AddParticle(_particle, *event);
 }
 //----------------------------------------------------------------------------------------------
 
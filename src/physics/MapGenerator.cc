@@ -0,0 +1,189 @@
+/*
+ * src/physics/MapGenerator.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/Generator.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+#include <G4UnitsTable.hh>
+#include <tls.hh>
+
+#include "physics/Units.hh"
+
+#include "util/string.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Parse Value List with Trailing Unit_________________________________________________________
+bool _parse_list(const std::string& value,
+                 std::vector<double>& out) {
+  std::vector<std::string> tokens;
+  util::string::split(value, tokens, " ");
+  tokens.erase(std::remove(tokens.begin(), tokens.end(), ""), tokens.end());
+  if (tokens.size() < 2UL)
+    return false;
+  std::vector<double> values;
+  try {
+    const auto unit = G4UIcommand::ValueOf(tokens.back().c_str());
+    for (std::size_t i{}; i < tokens.size() - 1UL; ++i)
+      values.push_back(std::stod(tokens[i]) * unit);
+  } catch (...) {
+    return false;
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  out = values;
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Join Value List in Units____________________________________________________________________
+const std::string _join_list(const std::vector<double>& values,
+                             const double unit,
+                             const std::string& unit_string) {
+  std::string out;
+  for (const auto& value : values)
+    out += std::to_string(value / unit) + " ";
+  return out + unit_string;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__MapGenerator Constructor____________________________________________________________________
+MapGenerator::MapGenerator(const std::string& name,
+                           const std::string& description,
+                           const Particle& particle)
+    : Generator(name, description, particle),
+      _energies{10*GeV, 20*GeV, 50*GeV, 100*GeV, 200*GeV, 500*GeV, 1000*GeV},
+      _angles{0*deg, 10*deg, 20*deg, 30*deg, 40*deg, 50*deg, 60*deg, 70*deg},
+      _count(1000UL) {
+  GenerateCommands();
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator UI Commands____________________________________________________________________
+void MapGenerator::GenerateCommands() {
+  _ui_energies = CreateCommand<Command::StringArg>("energies", "Set Kinetic Energy Grid: <value>... <unit>.");
+  _ui_energies->SetParameterName("energies", false);
+  _ui_energies->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_angles = CreateCommand<Command::StringArg>("angles", "Set Angle from Vertical Grid: <value>... <unit>.");
+  _ui_angles->SetParameterName("angles", false);
+  _ui_angles->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_count = CreateCommand<Command::IntegerArg>("count", "Set Number of Events per Grid Point.");
+  _ui_count->SetParameterName("count", false);
+  _ui_count->SetRange("count > 0");
+  _ui_count->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator Grid Point for Event___________________________________________________________
+std::size_t MapGenerator::point(std::size_t event_id) const {
+  return size() ? (event_id / _count) % size() : 0UL;
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator Kinetic Energy of Grid Point___________________________________________________
+double MapGenerator::energy(std::size_t point) const {
+  return _energies[point / _angles.size()];
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator Angle from Vertical of Grid Point______________________________________________
+double MapGenerator::angle(std::size_t point) const {
+  return _angles[point % _angles.size()];
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator Straight-Line Path to the Surface of Grid Point________________________________
+double MapGenerator::path(std::size_t point) const {
+  return _particle.z / std::cos(angle(point));
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator Generate Initial Particles_____________________________________________________
+void MapGenerator::GeneratePrimaryVertex(G4Event* event) {
+  if (!size())
+    return;
+  const auto index = point(event->GetEventID());
+  const auto theta = angle(index);
+  _particle.set_p_unit(std::sin(theta), 0, -std::cos(theta));
+  _particle.set_ke(energy(index));
+  AddParticle(_particle, *event);
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator Messenger Set Value____________________________________________________________
+void MapGenerator::SetNewValue(G4UIcommand* command,
+                               G4String value) {
+  if (command == _ui_energies) {
+    if (!_parse_list(value, _energies))
+      std::cout << "[MapGenerator] Expected: <energy>... <unit>\n";
+  } else if (command == _ui_angles) {
+    if (!_parse_list(value, _angles))
+      std::cout << "[MapGenerator] Expected: <angle>... <unit>\n";
+  } else if (command == _ui_count) {
+    _count = static_cast<std::size_t>(_ui_count->GetNewIntValue(value));
+  } else {
+    Generator::SetNewValue(command, value);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator Information String_____________________________________________________________
+std::ostream& MapGenerator::Print(std::ostream& os) const {
+  return os << "MapGenerator Info:\n  "
+            << "Name:        " << _name                                            << "\n  "
+            << "Description: " << _description                                     << "\n  "
+            << "Particle ID: " << _particle.id                                     << "\n  "
+            << "Energies:    " << _join_list(_energies, GeV, "GeV")                << "\n  "
+            << "Angles:      " << _join_list(_angles, deg, "deg")                  << "\n  "
+            << "Count:       " << _count << " per point, " << _count * size() << " total\n  "
+            << "vertex:      (" << G4BestUnit(_particle.t, "Time")   << ", "
+                                << G4BestUnit(_particle.x, "Length") << ", "
+                                << G4BestUnit(_particle.y, "Length") << ", "
+                                << G4BestUnit(_particle.z, "Length") << ")\n";
+}
+//----------------------------------------------------------------------------------------------
+
+//__MapGenerator Specifications_________________________________________________________________
+const Analysis::SimSettingList MapGenerator::GetSpecification() const {
+  return Analysis::Settings(SimSettingPrefix,
+    "",          _name,
+    "_PDG_ID",   std::to_string(_particle.id),
+    "_ENERGIES", _join_list(_energies, Units::Energy, Units::EnergyString),
+    "_ANGLES",   _join_list(_angles, Units::Angle, Units::AngleString),
+    "_COUNT",    std::to_string(_count),
+    "_VERTEX",   "(" + std::to_string(_particle.t / Units::Time)   + ", "
+                     + std::to_string(_particle.x / Units::Length) + ", "
+                     + std::to_string(_particle.y / Units::Length) + ", "
+                     + std::to_string(_particle.z / Units::Length) + ")");
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
@@ -0,0 +1,695 @@
+/*
+ * src/physics/MuonTransport.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/MuonTransport.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include <G4AutoDelete.hh>
+#include <G4AutoLock.hh>
+#include <G4EmCalculator.hh>
+#include <G4Event.hh>
+#include <G4EventManager.hh>
+#include <G4FastStep.hh>
+#include <G4FastTrack.hh>
+#include <G4MuonMinus.hh>
+#include <G4MuonPlus.hh>
+#include <G4RegionStore.hh>
+#include <G4TransportationManager.hh>
+#include <G4UnitsTable.hh>
+#include <Randomize.hh>
+#include <tls.hh>
+
+#include <TFile.h>
+#include <TH1D.h>
+
+#include "geometry/Construction.hh"
+#include "util/string.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace MuonTransport { ///////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Muon Transport State________________________________________________________________________
+bool _enabled = false;
+bool _validate = false;
+double _emin = 1*GeV;
+double _min_path = 1*m;
+Messenger* _messenger = nullptr;
+std::vector<std::string> _material_names{"CaCO3", "Clay", "Quartz", "Marl", "Mix"};
+//----------------------------------------------------------------------------------------------
+
+//__Transport Counters__________________________________________________________________________
+std::atomic<std::size_t> _transported_count{};
+std::atomic<std::size_t> _stopped_count{};
+//----------------------------------------------------------------------------------------------
+
+//__Energy Grid for Range Tables________________________________________________________________
+constexpr double _table_emin = 1*MeV;
+constexpr std::size_t _table_decades = 8UL;
+constexpr std::size_t _table_points_per_decade = 20UL;
+//----------------------------------------------------------------------------------------------
+
+//__Exit Distributions for Fast and Full Transport______________________________________________
+struct _distribution {
+  TH1D* loss;
+  TH1D* angle;
+  TH1D* displacement;
+};
+_distribution _fast{}, _full{};
+G4Mutex _mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Entry State of Muon Crossing the Rock (Validation Mode)______________________________________
+struct _entry {
+  G4ThreeVector position, direction;
+  double kinetic_energy;
+};
+G4ThreadLocal Model* _model = nullptr;
+G4ThreadLocal G4Region* _envelope = nullptr;
+G4ThreadLocal std::unordered_map<int, _entry>* _entries = nullptr;
+G4ThreadLocal G4int _entries_event = -1;
+//----------------------------------------------------------------------------------------------
+
+//__Create Exit Distribution Histograms_________________________________________________________
+_distribution _create_distribution(const std::string& tag) {
+  _distribution out;
+  out.loss = new TH1D(("muon_transport_loss_" + tag).c_str(),
+    "Fractional Energy Loss (Stopped = 1);#DeltaE / E;muons", 101, 0, 1.01);
+  out.angle = new TH1D(("muon_transport_angle_" + tag).c_str(),
+    "Deflection Angle;#theta [mrad];muons", 100, 0, 100);
+  out.displacement = new TH1D(("muon_transport_displacement_" + tag).c_str(),
+    "Lateral Displacement;d [cm];muons", 100, 0, 500);
+  for (auto histogram : {out.loss, out.angle, out.displacement})
+    histogram->SetDirectory(nullptr);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Fill Exit Distribution______________________________________________________________________
+void _fill(_distribution& distribution,
+           const _entry& entry,
+           const G4ThreeVector& position,
+           const G4ThreeVector& direction,
+           const double kinetic_energy,
+           const bool stopped) {
+  const auto offset = position - entry.position;
+  G4AutoLock lock(&_mutex);
+  distribution.loss->Fill(stopped ? 1.0 : 1.0 - kinetic_energy / entry.kinetic_energy);
+  if (!stopped) {
+    distribution.angle->Fill(entry.direction.angle(direction) / mrad);
+    distribution.displacement->Fill((offset - offset.dot(entry.direction) * entry.direction).mag() / cm);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Material is Transported Analytically_______________________________________________
+bool _is_transport_material(const G4Material* material) {
+  return material && std::find(_material_names.cbegin(), _material_names.cend(),
+                               material->GetName()) != _material_names.cend();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Volume is Rock Inside the Envelope_________________________________________________
+bool _in_envelope(const G4VPhysicalVolume* volume) {
+  if (!volume)
+    return false;
+  const auto logical = volume->GetLogicalVolume();
+  return logical->GetRegion() == _envelope && _is_transport_material(logical->GetMaterial());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Validation Entries for Current Event____________________________________________________
+std::unordered_map<int, _entry>& _current_entries() {
+  if (!_entries) {
+    _entries = new std::unordered_map<int, _entry>;
+    G4AutoDelete::Register(_entries);
+  }
+  const auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const auto event_id = event ? event->GetEventID() : -1;
+  if (event_id != _entries_event) {
+    _entries->clear();
+    _entries_event = event_id;
+  }
+  return *_entries;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Linear Interpolation in Monotonic Table_____________________________________________________
+double _interpolate(const std::vector<double>& x,
+                    const std::vector<double>& y,
+                    const double value) {
+  auto upper = std::upper_bound(x.cbegin(), x.cend(), value);
+  if (upper == x.cbegin())
+    return y.front() * value / x.front();
+  if (upper == x.cend())
+    upper = x.cend() - 1;
+  const auto i = static_cast<std::size_t>(upper - x.cbegin());
+  return y[i - 1] + (y[i] - y[i - 1]) * (value - x[i - 1]) / (x[i] - x[i - 1]);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Momentum times Velocity_____________________________________________________________________
+double _p_beta(const double kinetic_energy,
+               const double mass) {
+  return kinetic_energy * (kinetic_energy + 2 * mass) / (kinetic_energy + mass);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transfer Map Lookup Table______________________________________________________________
+struct _map_cell {
+  double generated, survived;
+  std::vector<double> loss, deflection;
+};
+struct _map_table {
+  std::vector<double> energies, columns;
+  std::vector<_map_cell> cells;
+};
+_map_table _map;
+std::string _map_path;
+//----------------------------------------------------------------------------------------------
+
+//__Load Muon Transfer Map Written by MuonMapper________________________________________________
+// cells are keyed on energy and column density, so maps without column densities are refused
+bool _load_map(const std::string& path) {
+  std::ifstream file(path);
+  if (!file)
+    return false;
+
+  struct row { double energy, column; _map_cell cell; };
+  std::vector<row> rows;
+  std::size_t version{1UL}, quantiles{};
+  std::string line;
+  while (std::getline(file, line)) {
+    util::string::strip(line);
+    if (line.empty())
+      continue;
+    if (line[0] == '#') {
+      if (line.rfind("# version", 0) == 0)
+        version = std::stoul(line.substr(9));
+      else if (line.rfind("# quantiles", 0) == 0)
+        quantiles = std::stoul(line.substr(11));
+      continue;
+    }
+    if (version < 2UL) {
+      std::cout << "[MuonTransport] Muon Map has no Column Densities. Regenerate it with MuonMapper.\n";
+      return false;
+    }
+    if (quantiles < 2UL)
+      return false;
+
+    std::istringstream stream(line);
+    row entry;
+    double angle, length;
+    stream >> entry.energy >> angle >> length >> entry.column >> entry.cell.generated >> entry.cell.survived;
+    entry.cell.loss.resize(quantiles);
+    entry.cell.deflection.resize(quantiles);
+    for (auto& value : entry.cell.loss)
+      stream >> value;
+    for (auto& value : entry.cell.deflection)
+      stream >> value;
+    if (!stream)
+      return false;
+    entry.energy *= GeV;
+    entry.column *= g/cm2;
+    for (auto& value : entry.cell.deflection)
+      value *= mrad;
+    rows.push_back(std::move(entry));
+  }
+  if (rows.empty())
+    return false;
+
+  _map_table table;
+  for (const auto& entry : rows) {
+    table.energies.push_back(entry.energy);
+    table.columns.push_back(entry.column);
+  }
+  for (auto grid : {&table.energies, &table.columns}) {
+    std::sort(grid->begin(), grid->end());
+    grid->erase(std::unique(grid->begin(), grid->end()), grid->end());
+  }
+  table.cells.assign(table.energies.size() * table.columns.size(), _map_cell{});
+  for (auto& entry : rows) {
+    const auto i = std::lower_bound(table.energies.cbegin(), table.energies.cend(), entry.energy) - table.energies.cbegin();
+    const auto j = std::lower_bound(table.columns.cbegin(), table.columns.cend(), entry.column) - table.columns.cbegin();
+    table.cells[i * table.columns.size() + j] = std::move(entry.cell);
+  }
+  _map = std::move(table);
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Pick Neighbouring Grid Index with Interpolation Probability_________________________________
+bool _pick(const std::vector<double>& grid,
+           const double value,
+           const bool logarithmic,
+           std::size_t& index) {
+  if (grid.empty() || value < grid.front() || value > grid.back())
+    return false;
+  const auto upper = std::upper_bound(grid.cbegin(), grid.cend(), value);
+  if (upper == grid.cend()) {
+    index = grid.size() - 1UL;
+    return true;
+  }
+  const auto i = static_cast<std::size_t>(upper - grid.cbegin());
+  const auto fraction = logarithmic
+    ? std::log(value / grid[i - 1]) / std::log(grid[i] / grid[i - 1])
+    : (value - grid[i - 1]) / (grid[i] - grid[i - 1]);
+  index = G4UniformRand() < fraction ? i : i - 1UL;
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Find Transfer Map Cell for Energy and Column Density________________________________________
+const _map_cell* _find_cell(const double energy,
+                            const double column) {
+  std::size_t i, j;
+  if (!_pick(_map.energies, energy, true, i) || !_pick(_map.columns, column, false, j))
+    return nullptr;
+  const auto& cell = _map.cells[i * _map.columns.size() + j];
+  return cell.generated > 0 ? &cell : nullptr;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sample from Quantile Table__________________________________________________________________
+double _sample_quantiles(const std::vector<double>& quantiles) {
+  const auto u = G4UniformRand() * (quantiles.size() - 1UL);
+  const auto k = std::min(static_cast<std::size_t>(u), quantiles.size() - 2UL);
+  return quantiles[k] + (quantiles[k + 1UL] - quantiles[k]) * (u - k);
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Model Constructor___________________________________________________________________________
+Model::Model(G4Region* envelope)
+    : G4VFastSimulationModel("MuonTransport", envelope), _geometry_version(0UL) {}
+//----------------------------------------------------------------------------------------------
+
+//__Model Applies to Muons______________________________________________________________________
+G4bool Model::IsApplicable(const G4ParticleDefinition& particle) {
+  return &particle == G4MuonMinus::Definition() || &particle == G4MuonPlus::Definition();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Trigger on Muons Entering Rock______________________________________________________________
+G4bool Model::ModelTrigger(const G4FastTrack& fast_track) {
+  const auto track = fast_track.GetPrimaryTrack();
+  if (track->GetKineticEnergy() < _emin || !_is_transport_material(track->GetMaterial()))
+    return false;
+
+  if (_validate && _current_entries().count(track->GetTrackID()))
+    return false;
+
+  if (!_walk(track->GetPosition(), track->GetMomentumDirection()))
+    return false;
+
+  _result = _transport(*track);
+
+  const _entry entry{track->GetPosition(), track->GetMomentumDirection(), track->GetKineticEnergy()};
+  _fill(_fast, entry, _result.position, _result.direction, _result.kinetic_energy, _result.stopped);
+
+  if (_validate) {
+    _current_entries()[track->GetTrackID()] = entry;
+    return false;
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Move Muon to Rock Boundary__________________________________________________________________
+void Model::DoIt(const G4FastTrack&,
+                 G4FastStep& step) {
+  step.ProposePrimaryTrackPathLength(_result.path_length);
+  step.ProposePrimaryTrackFinalPosition(_result.position, false);
+  step.ProposePrimaryTrackFinalTime(_result.time);
+  step.ProposeTotalEnergyDeposited(_result.deposit);
+  if (_result.stopped) {
+    step.ProposePrimaryTrackFinalKineticEnergy(0);
+    step.KillPrimaryTrack();
+    ++_stopped_count;
+  } else {
+    step.ProposePrimaryTrackFinalKineticEnergyAndDirection(_result.kinetic_energy, _result.direction, false);
+    ++_transported_count;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Range Table for Particle in Material________________________________________________________
+const Model::Table& Model::_table(const G4ParticleDefinition* particle,
+                                  const G4Material* material) {
+  auto& tables = _tables[particle == G4MuonPlus::Definition()];
+  const auto search = tables.find(material);
+  if (search != tables.cend())
+    return search->second;
+
+  G4EmCalculator calculator;
+  Table table;
+  table.radiation_length = material->GetRadlen();
+  table.electron_density = material->GetElectronDensity();
+
+  const auto size = 1UL + _table_decades * _table_points_per_decade;
+  table.energy.reserve(size);
+  table.range.reserve(size);
+  double previous_inverse{};
+  for (std::size_t i{}; i < size; ++i) {
+    const auto energy = _table_emin * std::pow(10.0, i / static_cast<double>(_table_points_per_decade));
+    const auto inverse = 1.0 / std::max(calculator.ComputeTotalDEDX(energy, particle, material), 1e-12);
+    table.range.push_back(i ? table.range.back() + 0.5 * (inverse + previous_inverse) * (energy - table.energy.back())
+                            : energy * inverse);
+    table.energy.push_back(energy);
+    previous_inverse = inverse;
+  }
+  return tables.emplace(material, std::move(table)).first->second;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Collect Straight-Line Segments Through Rock_________________________________________________
+bool Model::_walk(const G4ThreeVector& position,
+                  const G4ThreeVector& direction) {
+  const auto geometry = Construction::Builder::GetGeometryVersion();
+  if (!_navigator.GetWorldVolume() || _geometry_version != geometry) {
+    _geometry_version = geometry;
+    _navigator.SetWorldVolume(
+      G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+    _navigator.ResetStackAndState();
+  }
+
+  _segments.clear();
+  auto point = position;
+  auto volume = _navigator.LocateGlobalPointAndSetup(point, &direction, false, false);
+  double total{};
+  for (std::size_t i{}; i < 1000UL && _in_envelope(volume); ++i) {
+    G4double safety;
+    const auto length = _navigator.ComputeStep(point, direction, kInfinity, safety);
+    if (length == kInfinity)
+      return false;
+    _segments.push_back({volume->GetLogicalVolume()->GetMaterial(), length});
+    total += length;
+    point += length * direction;
+    _navigator.SetGeometricallyLimitedStep();
+    G4bool valid;
+    _exit_normal = _navigator.GetGlobalExitNormal(point, &valid);
+    if (!valid)
+      _exit_normal = direction;
+    volume = _navigator.LocateGlobalPointAndSetup(point, &direction, true);
+  }
+  return total >= _min_path && !_in_envelope(volume);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Transport Muon Along Collected Segments_____________________________________________________
+Model::Result Model::_transport(const G4Track& track) {
+  const auto particle = track.GetParticleDefinition();
+  const auto mass = particle->GetPDGMass();
+  const auto initial_energy = track.GetKineticEnergy();
+  const auto& direction = track.GetMomentumDirection();
+  const auto u = direction.orthogonal().unit();
+  const auto v = direction.cross(u);
+
+  Result result{};
+  auto energy = initial_energy;
+  auto final_direction = direction;
+  G4ThreeVector displacement;
+
+  double path{}, column{};
+  for (const auto& segment : _segments) {
+    path += segment.length;
+    column += segment.material->GetDensity() * segment.length;
+  }
+
+  if (const auto cell = _find_cell(initial_energy, column)) {
+    result.path_length = path;
+    result.stopped = G4UniformRand() * cell->generated >= cell->survived;
+    if (!result.stopped) {
+      energy = initial_energy * (1.0 - _sample_quantiles(cell->loss));
+      const auto theta = _sample_quantiles(cell->deflection);
+      const auto phi = twopi * G4UniformRand();
+      const auto axis = std::cos(phi) * u + std::sin(phi) * v;
+      final_direction = std::cos(theta) * direction + std::sin(theta) * axis;
+      displacement = path * theta / std::sqrt(3.0) * axis;
+    }
+  } else {
+    double radiation_lengths{}, variance{};
+    for (const auto& segment : _segments) {
+      const auto& table = _table(particle, segment.material);
+      const auto range = _interpolate(table.energy, table.range, energy);
+      const auto length = std::min(range, segment.length);
+      radiation_lengths += length / table.radiation_length;
+      variance += 4 * pi * classic_electr_radius * classic_electr_radius
+                * electron_mass_c2 * electron_mass_c2 * table.electron_density * length;
+      result.path_length += length;
+      if (range <= segment.length) {
+        result.stopped = true;
+        break;
+      }
+      energy = _interpolate(table.range, table.energy, range - segment.length);
+    }
+
+    if (!result.stopped) {
+      energy += G4RandGauss::shoot(0, std::sqrt(variance));
+      const auto p_beta = std::sqrt(_p_beta(initial_energy, mass) * _p_beta(std::max(energy, 0.0), mass));
+      const auto theta0 = radiation_lengths > 0 && p_beta > 0
+        ? 13.6*MeV / p_beta * std::sqrt(radiation_lengths) * (1 + 0.038 * std::log(radiation_lengths))
+        : 0.0;
+      for (const auto& axis : {u, v}) {
+        const auto z1 = G4RandGauss::shoot(), z2 = G4RandGauss::shoot();
+        displacement += (z1 * result.path_length * theta0 / std::sqrt(12.0)
+                       + z2 * result.path_length * theta0 / 2) * axis;
+        final_direction += std::tan(z2 * theta0) * axis;
+      }
+    }
+  }
+
+  if (result.stopped || energy <= 0) {
+    result.stopped = true;
+    result.kinetic_energy = 0;
+    result.direction = direction;
+    result.position = track.GetPosition() + result.path_length * direction;
+    result.time = track.GetGlobalTime() + result.path_length / c_light;
+    result.deposit = initial_energy;
+    return result;
+  }
+
+  displacement -= displacement.dot(_exit_normal) * _exit_normal;
+
+  const auto beta = [&](const double kinetic_energy) {
+    return std::sqrt(kinetic_energy * (kinetic_energy + 2 * mass)) / (kinetic_energy + mass); };
+
+  result.kinetic_energy = energy;
+  result.direction = final_direction.unit();
+  result.position = track.GetPosition() + result.path_length * direction + displacement;
+  result.time = track.GetGlobalTime()
+              + result.path_length / (0.5 * (beta(initial_energy) + beta(energy)) * c_light);
+  result.deposit = initial_energy - energy;
+  return result;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Messenger Directory Path_____________________________________________________
+const std::string Messenger::MessengerDirectory = "/fast/muon/";
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Messenger Constructor________________________________________________________
+Messenger::Messenger() : G4UImessenger(MessengerDirectory, "Parameterised Muon Transport through Rock.") {
+  _materials = CreateCommand<Command::StringArg>("materials",
+    "Set Materials Transported Analytically.");
+  _materials->SetParameterName("materials", false);
+  _materials->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _materials->SetToBeBroadcasted(false);
+
+  _emin = CreateCommand<Command::DoubleUnitArg>("emin",
+    "Set Minimum Kinetic Energy for Fast Transport.");
+  _emin->SetParameterName("emin", false, false);
+  _emin->SetRange("emin >= 0");
+  _emin->SetDefaultUnit("GeV");
+  _emin->SetUnitCandidates("MeV GeV TeV");
+  _emin->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _emin->SetToBeBroadcasted(false);
+
+  _min_path = CreateCommand<Command::DoubleUnitArg>("min_path",
+    "Set Minimum Rock Path Length for Fast Transport.");
+  _min_path->SetParameterName("min_path", false, false);
+  _min_path->SetRange("min_path >= 0");
+  _min_path->SetDefaultUnit("m");
+  _min_path->SetUnitCandidates("mm cm m");
+  _min_path->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _min_path->SetToBeBroadcasted(false);
+
+  _table = CreateCommand<Command::StringArg>("table",
+    "Load Muon Transfer Map for Energy Loss and Deflection (none to use Range Tables).");
+  _table->SetParameterName("table", false);
+  _table->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _table->SetToBeBroadcasted(false);
+
+  _validate = CreateCommand<Command::BoolArg>("validate",
+    "Use Full Tracking and Compare Exit Distributions with Fast Transport.");
+  _validate->SetParameterName("validate", false);
+  _validate->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _validate->SetToBeBroadcasted(false);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Muon Transport Settings.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Messenger Set New Value______________________________________________________
+void Messenger::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _materials) {
+    _material_names.clear();
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ,");
+    for (auto& token : tokens) {
+      util::string::strip(token);
+      if (!token.empty())
+        _material_names.push_back(token);
+    }
+  } else if (command == _table) {
+    if (value == "none") {
+      _map = _map_table{};
+      _map_path.clear();
+    } else if (_load_map(value)) {
+      _map_path = value;
+    } else {
+      std::cout << "[MuonTransport] Unable to Load Muon Map \"" << value << "\".\n";
+    }
+  } else if (command == _emin) {
+    MuonTransport::_emin = _emin->GetNewDoubleValue(value);
+  } else if (command == _min_path) {
+    MuonTransport::_min_path = _min_path->GetNewDoubleValue(value);
+  } else if (command == _validate) {
+    MuonTransport::_validate = _validate->GetNewBoolValue(value);
+  } else if (command == _print) {
+    std::cout << "Muon Transport: " << (MuonTransport::_validate ? "validate" : "fast")
+              << " | emin: " << G4BestUnit(MuonTransport::_emin, "Energy")
+              << " | min path: " << G4BestUnit(MuonTransport::_min_path, "Length")
+              << " | table: " << (_map_path.empty() ? "range" : _map_path)
+              << " | materials:";
+    for (const auto& name : _material_names)
+      std::cout << " " << name;
+    std::cout << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable Parameterised Muon Transport_________________________________________________________
+void Enable() {
+  if (_enabled)
+    return;
+  _fast = _create_distribution("fast");
+  _full = _create_distribution("full");
+  _messenger = new Messenger;
+  _enabled = true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Parameterised Muon Transport is Enabled____________________________________________
+bool IsEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Attach Model to Envelope Region (Once per Thread)___________________________________________
+void Attach(const std::string& region) {
+  if (!_enabled || _model)
+    return;
+  _envelope = G4RegionStore::GetInstance()->GetRegion(region, false);
+  if (!_envelope) {
+    std::cout << "[MuonTransport] Region \"" << region << "\" Not Found. Fast Transport Disabled.\n";
+    return;
+  }
+  _model = new Model(_envelope);
+  G4AutoDelete::Register(_model);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Validation Mode is Active__________________________________________________________
+bool Validating() {
+  return _enabled && _validate;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Record Full Tracking Exit for Validation____________________________________________________
+void Observe(const G4Step* step) {
+  if (!_validate || !_model)
+    return;
+
+  const auto track = step->GetTrack();
+  if (!_model->IsApplicable(*track->GetParticleDefinition())
+      || !_in_envelope(step->GetPreStepPoint()->GetPhysicalVolume()))
+    return;
+
+  auto& entries = _current_entries();
+  const auto search = entries.find(track->GetTrackID());
+  if (search == entries.end())
+    return;
+
+  const auto post_step_point = step->GetPostStepPoint();
+  const auto stopped = track->GetTrackStatus() == fStopAndKill || post_step_point->GetKineticEnergy() <= 0;
+  if (!stopped && _in_envelope(post_step_point->GetPhysicalVolume()))
+    return;
+
+  _fill(_full, search->second, post_step_point->GetPosition(), post_step_point->GetMomentumDirection(),
+        post_step_point->GetKineticEnergy(), stopped);
+  entries.erase(search);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Number of Muons Transported Through Rock________________________________________________
+std::size_t TransportedCount() {
+  return _transported_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Number of Muons Stopped in Rock_________________________________________________________
+std::size_t StoppedCount() {
+  return _stopped_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Transport Counters____________________________________________________________________
+void ResetCounters() {
+  _transported_count = 0UL;
+  _stopped_count = 0UL;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Exit Distributions and Reset__________________________________________________________
+void Save(TFile* file) {
+  if (!_enabled || !file)
+    return;
+  G4AutoLock lock(&_mutex);
+  file->cd();
+  for (auto histogram : {_fast.loss, _fast.angle, _fast.displacement,
+                         _full.loss, _full.angle, _full.displacement}) {
+    histogram->Write();
+    histogram->Reset();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace MuonTransport */ ////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
@@ -263,9 +263,12 @@ void Particle::set_vertex(const G4ThreeVector& vertex) {
 
 //__Add Momentum and Vertex Particle To Event___________________________________________________
 void AddParticle(const Particle& particle,
-                 G4Event& event) {
+                 G4Event& event,
+                 const double weight) {
   const auto vertex = new G4PrimaryVertex(particle.x, particle.y, particle.z, particle.t);
-  vertex->SetPrimary(new G4PrimaryParticle(particle.id, particle.px, particle.py, particle.pz));
+  const auto primary = new G4PrimaryParticle(particle.id, particle.px, particle.py, particle.pz);
+  primary->SetWeight(weight);
+  vertex->SetPrimary(primary);
   event.AddPrimaryVertex(vertex);
 }
 //----------------------------------------------------------------------------------------------
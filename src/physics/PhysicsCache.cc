@@ -0,0 +1,252 @@
+/*
+ * src/physics/PhysicsCache.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/PhysicsCache.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <unistd.h>
+
+#include <G4Material.hh>
+#include <G4ProductionCuts.hh>
+#include <G4RegionStore.hh>
+#include <G4RunManagerKernel.hh>
+#include <G4StateManager.hh>
+#include <G4Version.hh>
+#include <G4VModularPhysicsList.hh>
+#include <G4VPhysicsConstructor.hh>
+
+#include <TFile.h>
+#include <TNamed.h>
+
+#include "util/io.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace PhysicsCache { ///////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Physics Table Cache State___________________________________________________________________
+bool _enabled = false;
+std::string _directory;
+std::string _physics;
+std::string _key;
+std::string _description;
+bool _retrieved = false;
+bool _pending_store = false;
+StateHook* _hook = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Key Description File Name___________________________________________________________________
+const std::string _key_file = "cache.key";
+//----------------------------------------------------------------------------------------------
+
+//__Describe Everything the Physics Tables Depend On____________________________________________
+// the tables depend on the Geant4 version, the physics constructors and their options, the
+// production cuts of every region and the full material table
+std::string _describe(const G4VUserPhysicsList* list) {
+  std::ostringstream out;
+  out << std::setprecision(12);
+  out << "geant4 " << G4VERSION_NUMBER << "\n";
+  out << "physics " << _physics << "\n";
+
+  if (const auto modular = dynamic_cast<const G4VModularPhysicsList*>(list))
+    for (G4int i{}; const auto constructor = modular->GetPhysics(i); ++i)
+      out << "constructor " << constructor->GetPhysicsName() << "\n";
+
+  out << "default_cut " << list->GetDefaultCutValue() << "\n";
+  for (const auto region : *G4RegionStore::GetInstance()) {
+    out << "region " << region->GetName();
+    if (const auto cuts = region->GetProductionCuts())
+      for (G4int i{}; i < NumberOfG4CutIndex; ++i)
+        out << " " << cuts->GetProductionCut(i);
+    out << "\n";
+  }
+
+  for (const auto material : *G4Material::GetMaterialTable()) {
+    out << "material " << material->GetName()
+        << " " << material->GetDensity()
+        << " " << material->GetState()
+        << " " << material->GetTemperature()
+        << " " << material->GetPressure();
+    const auto fractions = material->GetFractionVector();
+    for (std::size_t i{}; i < material->GetNumberOfElements(); ++i)
+      out << " " << material->GetElement(i)->GetName() << ":" << fractions[i];
+    out << "\n";
+  }
+  return out.str();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stable 64-bit Hash of Description (FNV-1a)__________________________________________________
+std::string _hash(const std::string& text) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const auto c : text) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream out;
+  out << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return out.str();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Cache Entry Matches Description____________________________________________________
+bool _cached(const std::string& path,
+             const std::string& description) {
+  std::ifstream file(path + "/" + _key_file);
+  if (!file)
+    return false;
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str() == description;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Prepare Retrieval or Storage before Tables are Built________________________________________
+void _prepare(G4VUserPhysicsList* list) {
+  const auto description = _describe(list);
+  const auto key = _hash(description);
+  if (key == _key)
+    return;
+
+  _key = key;
+  _description = description;
+  const auto path = _directory + "/" + _key;
+  _retrieved = _cached(path, _description);
+  _pending_store = !_retrieved;
+  if (_retrieved) {
+    std::cout << "[PhysicsCache] Retrieving Physics Tables from " << path << "\n";
+    list->SetPhysicsTableRetrieved(path);
+  } else {
+    std::cout << "[PhysicsCache] No Physics Tables for Key " << _key << ". Building.\n";
+    list->ResetPhysicsTableRetrieved();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Store Built Tables under their Key__________________________________________________________
+// tables are written to a private directory and renamed into place, so concurrent farm jobs
+// never read a partially written entry
+void _store(G4VUserPhysicsList* list) {
+  if (!_pending_store)
+    return;
+  _pending_store = false;
+
+  const auto path = _directory + "/" + _key;
+  const auto staging = path + ".tmp" + std::to_string(getpid());
+  util::io::create_directory(_directory);
+  util::io::create_directory(staging);
+  if (!list->StorePhysicsTable(staging)) {
+    std::cout << "[PhysicsCache] Unable to Store Physics Tables in " << staging << "\n";
+    return;
+  }
+
+  std::ofstream file(staging + "/" + _key_file);
+  file << _description;
+  file.close();
+
+  if (util::io::rename_file(staging, path))
+    std::cout << "[PhysicsCache] Stored Physics Tables in " << path << "\n";
+  else
+    std::cout << "[PhysicsCache] Physics Tables for Key " << _key << " Already Stored. "
+              << "Leaving " << staging << ".\n";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Cache Setting to File_________________________________________________________________
+void _write_setting(TFile* file,
+                    const std::string& name,
+                    const std::string& text) {
+  TNamed entry(name.c_str(), text.c_str());
+  file->cd();
+  entry.Write();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Physics Table Cache State Hook Constructor__________________________________________________
+StateHook::StateHook() : G4VStateDependent() {}
+//----------------------------------------------------------------------------------------------
+
+//__Prepare Cache before and Store after Table Building_________________________________________
+// run initialization leaves Idle for Init right before the kernel builds the physics tables,
+// so region cuts set in the user script are part of the key, then returns to Idle and enters
+// GeomClosed once they are built, which is where a pending store is written
+G4bool StateHook::Notify(G4ApplicationState requested) {
+  const auto previous = G4StateManager::GetStateManager()->GetPreviousState();
+  const auto list = G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList();
+  if (!list)
+    return true;
+
+  if (requested == G4State_Init && previous == G4State_Idle)
+    _prepare(list);
+  else if (requested == G4State_GeomClosed && _pending_store)
+    _store(list);
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable Physics Table Cache__________________________________________________________________
+void Enable(const std::string& directory,
+            const std::string& physics) {
+  if (_enabled)
+    return;
+  _directory = directory;
+  _physics = physics;
+  _hook = new StateHook;
+  _enabled = true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Physics Table Cache is Enabled_____________________________________________________
+bool IsEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Physics Table Cache Key_____________________________________________________________________
+const std::string& Key() {
+  return _key;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Physics Tables were Retrieved______________________________________________________
+bool Retrieved() {
+  return _retrieved;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Physics Table Cache Status____________________________________________________________
+void Save(TFile* file) {
+  if (!_enabled || !file)
+    return;
+  _write_setting(file, "PHYSICS_CACHE", _directory + "/" + _key);
+  _write_setting(file, "PHYSICS_CACHE_HIT", _retrieved ? "true" : "false");
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace PhysicsCache */ /////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
@@ -8,6 +8,7 @@
 #include <Randomize.hh>
 #include <G4ParticleTable.hh>
 
+#include "physics/Acceptance.hh"
 #include "physics/Units.hh"
 
 #include "util/string.hh"
@@ -81,7 +82,8 @@ void PolarGenerator::GeneratePrimaryVertex(G4Event* event) {
         _particle.pz = momentum_mag * std::cos(_polar);
     }
 
-    AddParticle(_particle, *event);
+    if (Acceptance::Select(_particle))
+        AddParticle(_particle, *event);
 }
 //----------------------------------------------------------------------------------------------
 
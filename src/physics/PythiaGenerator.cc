@@ -1,12 +1,24 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #include "physics/PythiaGenerator.hh"
 
 #include <Pythia8/ParticleData.h>
 
+#include <G4RunManager.hh>
+
 #include "geometry/Earth.hh"
 #include "geometry/Cavern.hh"
 #include "geometry/Box.hh"
+#include "physics/Acceptance.hh"
 #include "physics/Units.hh"
 #include "util/string.hh"
 
@@ -42,7 +54,7 @@ G4ThreadLocal double PythiaDisplacedFilter::_zHiCut=169500.;
 
 //__Pythia Generator Construction_______________________________________________________________
 PythiaGenerator::PythiaGenerator(Pythia8::Pythia* pythia)
-    : Generator("pythia", "Pythia8 Generator.") {
+    : Generator("pythia", "Pythia8 Generator."), _filter(nullptr), _counter(0ULL), _cache_trials(0ULL) {
   _pythia_settings = new std::vector<std::string>();
   SetPythia(pythia);
 
@@ -62,6 +74,20 @@ PythiaGenerator::PythiaGenerator(Pythia8::Pythia* pythia)
   _add_filter_cut->SetParameterName("filter_cut", false);
   _add_filter_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
 
+  _set_producers = CreateCommand<Command::IntegerArg>("producers", "Set Number of Pythia Producer Threads (0 to Generate Inline).");
+  _set_producers->SetParameterName("producers", false);
+  _set_producers->SetRange("producers >= 0");
+  _set_producers->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _set_queue = CreateCommand<Command::IntegerArg>("queue", "Set Capacity of the Producer Event Queue.");
+  _set_queue->SetParameterName("capacity", false);
+  _set_queue->SetRange("capacity > 0");
+  _set_queue->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _cache_events = CreateCommand<Command::StringArg>("cache", "Write Accepted Events to or Replay them from a Cache File.");
+  _cache_events->SetParameterName("mode file", false);
+  _cache_events->AvailableForStates(G4State_PreInit, G4State_Idle);
+
 }
 //----------------------------------------------------------------------------------------------
 
@@ -81,14 +107,15 @@ PythiaGenerator::PythiaGenerator(Pythia8::Pythia* pythia)
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
 //__Setup Pythia Randomness_____________________________________________________________________
-Pythia8::Pythia* _setup_random(Pythia8::Pythia* pythia) {
+Pythia8::Pythia* _setup_random(Pythia8::Pythia* pythia,
+                               const long int stream=0L) {
   struct timeval curTime;
   gettimeofday(&curTime, NULL);
   long int micro_sec = curTime.tv_usec;
 
   pythia->readString("Random:setSeed = on");
   std::ostringstream oss;
-  oss << "Random:seed = " << micro_sec;
+  oss << "Random:seed = " << (micro_sec + 1000003L * stream) % 900000000L;
   pythia->readString(oss.str());
   pythia->readString("Next:showScaleAndVertex = on");
   return pythia;
@@ -134,11 +161,519 @@ Particle _convert_particle(const Pythia8::Particle& particle) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Filter Cuts Copied into Producer Threads____________________________________________________
+// the filter cuts are thread-local, so producers start from the values of the worker thread
+struct _filter_cuts {
+  double prompt[6], displaced[6];
+
+  static _filter_cuts capture() {
+    return {{PythiaPromptMuonFilter::_pCut,     PythiaPromptMuonFilter::_ptCut,
+             PythiaPromptMuonFilter::_etaLoCut, PythiaPromptMuonFilter::_etaHiCut,
+             PythiaPromptMuonFilter::_phiLoCut, PythiaPromptMuonFilter::_phiHiCut},
+            {PythiaDisplacedFilter::_xLoCut, PythiaDisplacedFilter::_xHiCut,
+             PythiaDisplacedFilter::_yLoCut, PythiaDisplacedFilter::_yHiCut,
+             PythiaDisplacedFilter::_zLoCut, PythiaDisplacedFilter::_zHiCut}};
+  }
+
+  void apply() const {
+    PythiaPromptMuonFilter::_pCut     = prompt[0];
+    PythiaPromptMuonFilter::_ptCut    = prompt[1];
+    PythiaPromptMuonFilter::_etaLoCut = prompt[2];
+    PythiaPromptMuonFilter::_etaHiCut = prompt[3];
+    PythiaPromptMuonFilter::_phiLoCut = prompt[4];
+    PythiaPromptMuonFilter::_phiHiCut = prompt[5];
+    PythiaDisplacedFilter::_xLoCut = displaced[0];
+    PythiaDisplacedFilter::_xHiCut = displaced[1];
+    PythiaDisplacedFilter::_yLoCut = displaced[2];
+    PythiaDisplacedFilter::_yHiCut = displaced[3];
+    PythiaDisplacedFilter::_zLoCut = displaced[4];
+    PythiaDisplacedFilter::_zHiCut = displaced[5];
+  }
+};
+//----------------------------------------------------------------------------------------------
+
+//__Create Filter of Named Type_________________________________________________________________
+PythiaFilter* _make_filter(const std::string& name) {
+  if (name == "PythiaPromptMuonFilter")
+    return new PythiaPromptMuonFilter();
+  if (name == "PythiaDisplacedFilter")
+    return new PythiaDisplacedFilter();
+  return new PythiaFilter();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Filter-Accepted Event Ready for Geant4 (with Pythia Events it Stands For)___________________
+struct _produced_event {
+  GenParticleVector particles;
+  ParticleVector primaries;
+  std::uint_fast64_t trials;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Fill Event Record and Primaries from Filtered Pythia Event__________________________________
+void _fill_event(const Pythia8::Event& event,
+                 const std::vector<int>& indexlist,
+                 _produced_event& out) {
+  out.particles.clear();
+  out.primaries.clear();
+  for (int i = 0; i < event.size(); ++i)
+    out.particles.push_back(event[i]);
+
+  // add the G4index to the event record (add 1 to match Geant4!)
+  for (std::size_t i{}; i < indexlist.size(); ++i) {
+    out.particles[indexlist[i]].G4index = i + 1;
+    out.primaries.push_back(_convert_particle(event[indexlist[i]]));
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Pool of Pythia Producer Threads Filling a Bounded Queue_____________________________________
+class _producer_pool {
+public:
+  _producer_pool(const std::vector<std::string>& settings,
+                 const std::string& path,
+                 const std::string& filter,
+                 const std::size_t producers,
+                 const std::size_t capacity)
+      : _capacity(capacity), _stop(false), _running(producers) {
+    const auto cuts = _filter_cuts::capture();
+    for (std::size_t i{}; i < producers; ++i)
+      _threads.emplace_back(&_producer_pool::_produce, this, settings, path, filter, cuts, i + 1);
+  }
+
+  ~_producer_pool() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _not_full.notify_all();
+    for (auto& thread : _threads)
+      thread.join();
+  }
+
+  bool pop(_produced_event& out) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_empty.wait(lock, [&] { return !_queue.empty() || !_running; });
+    if (_queue.empty())
+      return false;
+    out = std::move(_queue.front());
+    _queue.pop_front();
+    _not_full.notify_one();
+    return true;
+  }
+
+private:
+  void _produce(const std::vector<std::string> settings,
+                const std::string path,
+                const std::string filter_name,
+                const _filter_cuts cuts,
+                const long int stream) {
+    cuts.apply();
+    std::unique_ptr<PythiaFilter> filter(_make_filter(filter_name));
+    std::unique_ptr<Pythia8::Pythia> pythia(new Pythia8::Pythia());
+    if (!path.empty())
+      pythia->readFile(path);
+    for (const auto& setting : settings)
+      pythia->readString(setting);
+    _setup_random(pythia.get(), stream);
+
+    if (pythia->init()) {
+      std::vector<int> indexlist;
+      _produced_event produced;
+      std::uint_fast64_t trials{};
+      while (!_stop) {
+        if (!pythia->next())
+          continue;
+        ++trials;
+        filter->GetParticles(pythia->event, indexlist);
+        if (indexlist.empty())
+          continue;
+        _fill_event(pythia->event, indexlist, produced);
+        produced.trials = trials;
+        trials = 0ULL;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _not_full.wait(lock, [&] { return _stop || _queue.size() < _capacity; });
+        if (_stop)
+          break;
+        _queue.push_back(std::move(produced));
+        _not_empty.notify_one();
+      }
+    } else {
+      std::cout << "\n[ERROR] Pythia Producer " << stream << " Failed to Initialize.\n";
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    --_running;
+    _not_empty.notify_all();
+  }
+
+  const std::size_t _capacity;
+  std::atomic<bool> _stop;
+  std::size_t _running;
+  std::deque<_produced_event> _queue;
+  std::mutex _mutex;
+  std::condition_variable _not_empty, _not_full;
+  std::vector<std::thread> _threads;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Producer Pool Shared by All Worker Threads__________________________________________________
+std::unique_ptr<_producer_pool> _pool;
+std::mutex _pool_mutex;
+std::atomic<std::size_t> _producer_count{0UL};
+std::atomic<std::size_t> _queue_capacity{64UL};
+//----------------------------------------------------------------------------------------------
+
+//__Stop Producer Pool after Configuration Change_______________________________________________
+void _stop_pool() {
+  std::lock_guard<std::mutex> lock(_pool_mutex);
+  _pool.reset();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Pythia Event Cache File Format______________________________________________________________
+// a cache file holds the magic string, the format version and the generator specification of
+// the writing run, then one record per filter-accepted event: the number of Pythia events it
+// stands for and its final-state particles (and any particle sent to Geant4) in the Pythia
+// frame, so a replay picks up the geometry and shift of the replaying run
+const char _cache_magic[8] = {'M', 'U', 'P', 'Y', 'T', 'H', 'I', 'A'};
+constexpr std::uint32_t _cache_version = 1U;
+//----------------------------------------------------------------------------------------------
+
+//__Write Fixed-Size Value to Binary Stream_____________________________________________________
+template<class T>
+void _put(std::ostream& out,
+          const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Read Fixed-Size Value from Binary Stream____________________________________________________
+template<class T>
+bool _get(std::istream& in,
+          T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write String to Binary Stream_______________________________________________________________
+void _put_string(std::ostream& out,
+                 const std::string& text) {
+  _put(out, static_cast<std::uint32_t>(text.size()));
+  out.write(text.data(), text.size());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Read String from Binary Stream______________________________________________________________
+bool _get_string(std::istream& in,
+                 std::string& text) {
+  std::uint32_t size;
+  if (!_get(in, size))
+    return false;
+  text.resize(size);
+  return size == 0U || static_cast<bool>(in.read(&text[0], size));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Generator Particle to Binary Stream___________________________________________________
+void _put_particle(std::ostream& out,
+                   const GenParticle& particle) {
+  for (const auto value : {particle.index, particle.pdgid, particle.status,
+                           particle.moid1, particle.moid2, particle.dau1, particle.dau2,
+                           particle.G4index})
+    _put(out, static_cast<std::int32_t>(value));
+  _put(out, static_cast<std::uint8_t>(particle.hasVertex));
+  for (const auto value : {particle.mom.px(), particle.mom.py(), particle.mom.pz(), particle.mom.e(),
+                           particle.vertex.px(), particle.vertex.py(), particle.vertex.pz(),
+                           particle.vertex.e(), particle.m, particle.weight})
+    _put(out, value);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Read Generator Particle from Binary Stream__________________________________________________
+bool _get_particle(std::istream& in,
+                   GenParticle& particle) {
+  std::int32_t ints[8];
+  std::uint8_t has_vertex;
+  double doubles[10];
+  for (auto& value : ints)
+    _get(in, value);
+  _get(in, has_vertex);
+  for (auto& value : doubles)
+    _get(in, value);
+  if (!in)
+    return false;
+
+  particle.index     = ints[0];
+  particle.pdgid     = ints[1];
+  particle.status    = ints[2];
+  particle.moid1     = ints[3];
+  particle.moid2     = ints[4];
+  particle.dau1      = ints[5];
+  particle.dau2      = ints[6];
+  particle.G4index   = ints[7];
+  particle.hasVertex = has_vertex;
+  particle.mom       = Pythia8::Vec4(doubles[0], doubles[1], doubles[2], doubles[3]);
+  particle.vertex    = Pythia8::Vec4(doubles[4], doubles[5], doubles[6], doubles[7]);
+  particle.m         = doubles[8];
+  particle.weight    = doubles[9];
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Setting Describes the Cache or Run Rather than the Events__________________________
+bool _run_setting(const std::string& name) {
+  for (const std::string suffix : {"_EVENTS", "_PRODUCERS", "_CACHE", "_CACHE_MODE"})
+    if (name.size() >= suffix.size()
+        && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+      return true;
+  return false;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Pythia Event Cache Shared by All Worker Threads_____________________________________________
+class _event_cache {
+public:
+  enum class Mode { Off, Write, Read };
+
+  bool open(const Mode mode,
+            const std::string& path) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // generator commands reach every worker, so reopening the current cache is a no-op
+    if (mode == _mode && path == _path)
+      return true;
+    _close();
+    if (mode == Mode::Off)
+      return true;
+
+    if (mode == Mode::Write) {
+      _out.open(path, std::ios::binary | std::ios::trunc);
+      if (!_out) {
+        std::cout << "\n[ERROR] Unable to Write Pythia Cache " << path << ".\n";
+        return false;
+      }
+    } else {
+      _in.open(path, std::ios::binary);
+      if (!_in || !_read_header()) {
+        std::cout << "\n[ERROR] " << path << " is not a Pythia Cache (Version "
+                  << _cache_version << ").\n";
+        _close();
+        return false;
+      }
+    }
+    _mode = mode;
+    _path = path;
+    return true;
+  }
+
+  Mode mode() const {
+    return _mode;
+  }
+
+  const std::string& path() const {
+    return _path;
+  }
+
+  const Analysis::SimSettingList& specification() const {
+    return _specification;
+  }
+
+  void write(const PythiaGenerator& generator,
+             const GenParticleVector& particles,
+             const std::uint_fast64_t trials) {
+    std::uint32_t count{};
+    for (const auto& particle : particles)
+      count += particle.status > 0 || particle.G4index > 0;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_mode != Mode::Write)
+      return;
+    if (!_header_written)
+      _write_header(generator.GetSpecification());
+
+    _put(_out, static_cast<std::uint64_t>(trials));
+    _put(_out, count);
+    for (const auto& particle : particles)
+      if (particle.status > 0 || particle.G4index > 0)
+        _put_particle(_out, particle);
+  }
+
+  bool read(GenParticleVector& particles,
+            std::uint_fast64_t& trials) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_mode != Mode::Read)
+      return false;
+
+    std::uint64_t stored_trials;
+    std::uint32_t count;
+    if (!_get(_in, stored_trials) || !_get(_in, count))
+      return false;
+    particles.resize(count);
+    for (auto& particle : particles)
+      if (!_get_particle(_in, particle))
+        return false;
+    trials = stored_trials;
+    return true;
+  }
+
+  ~_event_cache() {
+    _close();
+  }
+
+private:
+  void _close() {
+    if (_mode == Mode::Write && !_header_written)
+      _write_header({});
+    _out.close();
+    _in.close();
+    _in.clear();
+    _mode = Mode::Off;
+    _path.clear();
+    _specification.clear();
+    _header_written = false;
+  }
+
+  void _write_header(const Analysis::SimSettingList& specification) {
+    _out.write(_cache_magic, sizeof(_cache_magic));
+    _put(_out, _cache_version);
+    std::uint32_t count{};
+    for (const auto& setting : specification)
+      count += !_run_setting(setting.name);
+    _put(_out, count);
+    for (const auto& setting : specification) {
+      if (_run_setting(setting.name))
+        continue;
+      _put_string(_out, setting.name);
+      _put_string(_out, setting.text);
+    }
+    _header_written = true;
+  }
+
+  bool _read_header() {
+    char magic[sizeof(_cache_magic)];
+    std::uint32_t version, count;
+    if (!_in.read(magic, sizeof(magic))
+        || !std::equal(magic, magic + sizeof(magic), _cache_magic)
+        || !_get(_in, version) || version != _cache_version
+        || !_get(_in, count))
+      return false;
+    _specification.resize(count);
+    for (auto& setting : _specification)
+      if (!_get_string(_in, setting.name) || !_get_string(_in, setting.text))
+        return false;
+    return true;
+  }
+
+  std::mutex _mutex;
+  std::atomic<Mode> _mode{Mode::Off};
+  std::string _path;
+  std::ofstream _out;
+  std::ifstream _in;
+  bool _header_written = false;
+  Analysis::SimSettingList _specification;
+};
+_event_cache _cache;
+//----------------------------------------------------------------------------------------------
+
+//__Convert Cached Generator Particle to Particle_______________________________________________
+// mirrors the conversion of Pythia particles, starting from the stored Pythia-frame record
+Particle _convert_particle(const GenParticle& particle) {
+  const auto xz = Cavern::rotate_from_P1(particle.vertex.pz() * mm, -particle.vertex.px() * mm);
+  Particle out(particle.pdgid,
+               particle.vertex.e() * mm / c_light,
+               static_cast<double>(xz.first),
+               particle.vertex.py() * mm,
+               static_cast<double>(xz.second + Earth::TotalShift() + Box::Box_IP_Depth));
+  out.set_pseudo_lorentz_triplet(particle.mom.pT() * GeVperC, particle.mom.eta(), particle.mom.phi() * rad);
+  out.genParticleRef = particle.index;
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Apply Acceptance Prefilter to Primaries and Event Record____________________________________
+// primaries follow the record entries with a positive G4index, which are renumbered to keep
+// matching the Geant4 track IDs, dropped particles stay in the record with G4index 0
+void _select_primaries(GenParticleVector& record,
+                       ParticleVector& primaries) {
+  if (!Acceptance::IsActive())
+    return;
+
+  std::vector<bool> keep;
+  Acceptance::Select(primaries, keep);
+  std::vector<GenParticle*> sent;
+  for (auto& particle : record)
+    if (particle.G4index > 0)
+      sent.push_back(&particle);
+
+  ParticleVector kept;
+  int g4index{};
+  for (std::size_t i{}; i < primaries.size(); ++i) {
+    if (keep[i])
+      kept.push_back(primaries[i]);
+    if (i < sent.size())
+      sent[i]->G4index = keep[i] ? ++g4index : 0;
+  }
+  primaries = std::move(kept);
+}
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Generate Initial Particles__________________________________________________________________
 void PythiaGenerator::GeneratePrimaryVertex(G4Event* g4event) {
-  if (!_settings_on && !_pythia_settings->empty()) {
+  if(!_filter)
+    _filter=new PythiaFilter();
+
+  // replayed events come straight from the cache, Pythia is never initialized
+  if (_cache.mode() == _event_cache::Mode::Read) {
+    std::uint_fast64_t trials{};
+    if (!_cache.read(_last_event, trials)) {
+      std::cout << "\n[ERROR] Pythia Cache " << _cache.path() << " Exhausted. Aborting Run.\n";
+      _last_event.clear();
+      G4RunManager::GetRunManager()->AbortRun(true);
+      return;
+    }
+    _counter += trials;
+    ParticleVector primaries;
+    for (const auto& particle : _last_event)
+      if (particle.G4index > 0)
+        primaries.push_back(_convert_particle(particle));
+    _select_primaries(_last_event, primaries);
+    for (const auto& particle : primaries)
+      AddParticle(particle, *g4event);
+    return;
+  }
+
+  // with producer threads, filter-accepted events are popped from the shared queue and
+  // _counter also counts the rejected Pythia events generated before each of them
+  if (_producer_count && (!_pythia_settings->empty() || !_path.empty())) {
+    _producer_pool* pool;
+    {
+      std::lock_guard<std::mutex> lock(_pool_mutex);
+      if (!_pool)
+        _pool.reset(new _producer_pool(*_pythia_settings, _path, _filter->GetName(),
+                                       _producer_count, _queue_capacity));
+      pool = _pool.get();
+    }
+
+    _produced_event produced;
+    _last_event.clear();
+    if (!pool->pop(produced)) {
+      std::cout << "\n[ERROR] No Pythia Producer Running.\n";
+      return;
+    }
+    _counter += produced.trials;
+    _last_event = std::move(produced.particles);
+    if (_cache.mode() == _event_cache::Mode::Write)
+      _cache.write(*this, _last_event, produced.trials);
+    _select_primaries(_last_event, produced.primaries);
+    for (const auto& particle : produced.primaries)
+      AddParticle(particle, *g4event);
+    return;
+  }
+
+  if ((!_settings_on || !_pythia) && !_pythia_settings->empty()) {
     _pythia = _create_pythia(_pythia_settings, _settings_on);
   } else if (!_pythia) {
     std::cout << "\n[ERROR] No Pythia Configuration Specified.\n";
@@ -152,21 +687,29 @@ void PythiaGenerator::GeneratePrimaryVertex(G4Event* g4event) {
   for (int i = 0; i < _pythia->event.size(); ++i)
     _last_event.push_back(_pythia->event[i]);
 
-  if(!_filter)
-    _filter=new PythiaFilter();
-
   // "filtered" is what is sent to Geant4 for propagation
   std::vector<int> indexlist;
   _filter->GetParticles(_pythia->event, indexlist);
 
   // add the G4index to the _last_event information (add 1 to match Geant4!)
   // then convert it to a particle for addition to the g4event
+  ParticleVector primaries;
   for(unsigned long i = 0; i<indexlist.size(); ++i) {
     _last_event[indexlist[i]].G4index=i+1;
-    Particle p=_convert_particle(_pythia->event[indexlist[i]]);
-    AddParticle(p, *g4event);
+    primaries.push_back(_convert_particle(_pythia->event[indexlist[i]]));
   }
 
+  // rejected events are only counted, in the trials of the next accepted event
+  ++_cache_trials;
+  if (!indexlist.empty() && _cache.mode() == _event_cache::Mode::Write) {
+    _cache.write(*this, _last_event, _cache_trials);
+    _cache_trials = 0ULL;
+  }
+
+  _select_primaries(_last_event, primaries);
+  for (const auto& particle : primaries)
+    AddParticle(particle, *g4event);
+
 
 }
 
@@ -181,12 +724,33 @@ GenParticleVector PythiaGenerator::GetLastEvent() const {
 //__Messenger Set Value_________________________________________________________________________
 void PythiaGenerator::SetNewValue(G4UIcommand* command,
                                   G4String value) {
+  if (command == _read_string || command == _read_file || command == _add_filter
+      || command == _add_filter_cut || command == _set_producers || command == _set_queue)
+    _stop_pool();
+
   if (command == _read_string) {
     _pythia_settings->push_back(value);
     _settings_on = true;
   } else if (command == _read_file) {
     SetPythia(value);
     Generator::SetNewValue(command, value);
+  } else if (command == _set_producers) {
+    _producer_count = std::max(_set_producers->GetNewIntValue(value), 0);
+  } else if (command == _set_queue) {
+    _queue_capacity = std::max(_set_queue->GetNewIntValue(value), 1);
+  } else if (command == _cache_events) {
+    std::vector<std::string> tokens;
+    util::string::split(util::string::strip(value), tokens, " ");
+    const auto mode = tokens.empty() ? "" : tokens[0];
+    const auto path = tokens.size() > 1 ? tokens[1] : "";
+    _cache_trials = 0ULL;
+    if (mode == "off") {
+      _cache.open(_event_cache::Mode::Off, "");
+    } else if ((mode == "write" || mode == "read") && !path.empty()) {
+      _cache.open(mode == "write" ? _event_cache::Mode::Write : _event_cache::Mode::Read, path);
+    } else {
+      std::cout << "\n[ERROR] Usage: /gen/pythia/cache write|read <file> or /gen/pythia/cache off\n";
+    }
   } else if (command == _add_filter) {
     value.toLower();
     if(value.contains("promptmuon")) {
@@ -240,10 +804,12 @@ void PythiaGenerator::SetPythia(Pythia8::Pythia* pythia) {
 //----------------------------------------------------------------------------------------------
 
 //__Set Pythia Object from Settings_____________________________________________________________
+// Pythia is initialized from the settings on the first inline event, so producer threads and
+// cache replays never pay for it
 void PythiaGenerator::SetPythia(const std::vector<std::string>& settings) {
   *_pythia_settings = settings;
   _counter = 0ULL;
-  _pythia = _create_pythia(_pythia_settings, _settings_on);
+  _settings_on = false;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -262,6 +828,14 @@ void PythiaGenerator::SetPythia(const std::string& path) {
 
 //__PythiaGenerator Specifications______________________________________________________________
   const Analysis::SimSettingList PythiaGenerator::GetSpecification() const {
+    if (_cache.mode() == _event_cache::Mode::Read) {
+      auto out = _cache.specification();
+      out.emplace_back(SimSettingPrefix, "_CACHE", _cache.path());
+      out.emplace_back(SimSettingPrefix, "_CACHE_MODE", "read");
+      out.emplace_back(SimSettingPrefix, "_EVENTS", std::to_string(_counter));
+      return out;
+    }
+
     Analysis::SimSettingList config;
     if (_path.empty() && !_pythia_settings->empty()) {
       config = Analysis::IndexedSettings(SimSettingPrefix, "_SETTING_", *_pythia_settings);
@@ -281,6 +855,11 @@ void PythiaGenerator::SetPythia(const std::string& path) {
 
 
     out.emplace_back(SimSettingPrefix, "_EVENTS", std::to_string(_counter));
+    out.emplace_back(SimSettingPrefix, "_PRODUCERS", std::to_string(_producer_count));
+    if (_cache.mode() == _event_cache::Mode::Write) {
+      out.emplace_back(SimSettingPrefix, "_CACHE", _cache.path());
+      out.emplace_back(SimSettingPrefix, "_CACHE_MODE", "write");
+    }
 
     return out;
   }
@@ -6,6 +6,7 @@
 #include <Randomize.hh>
 #include <tls.hh>
 
+#include "physics/Acceptance.hh"
 #include "physics/Units.hh"
 
 #include <iostream>
@@ -93,7 +94,8 @@ void RangeGenerator::GeneratePrimaryVertex(G4Event* event) {
   } else {
     _particle.set_pseudo_lorentz_triplet(G4RandFlat::shoot(_min.pT(), _max.pT()), eta, phi);
   }
-  AddParticle(_particle, *event);
+  if (Acceptance::Select(_particle))
+    AddParticle(_particle, *event);
 }
 //----------------------------------------------------------------------------------------------
 
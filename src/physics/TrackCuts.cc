@@ -0,0 +1,489 @@
+/*
+ * src/physics/TrackCuts.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/TrackCuts.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <limits>
+
+#include <G4Event.hh>
+#include <G4EventManager.hh>
+#include <G4LossTableManager.hh>
+#include <G4ParticleTable.hh>
+#include <G4ProductionCutsTable.hh>
+#include <G4ProcessManager.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4UnitsTable.hh>
+
+#include <TFile.h>
+#include <TNamed.h>
+
+#include "geometry/Construction.hh"
+#include "util/string.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace TrackCuts { //////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Track Cut State_____________________________________________________________________________
+bool _enabled = false;
+bool _validate = false;
+Messenger* _messenger = nullptr;
+std::unordered_map<const G4ParticleDefinition*, Process::Cut> _cuts;
+//----------------------------------------------------------------------------------------------
+
+//__Range-Out Envelope and Margin_______________________________________________________________
+// the envelope version is bumped whenever its name changes so every thread reloads it
+std::string _range_envelope;
+std::atomic<std::size_t> _range_envelope_version{1UL};
+double _range_margin = 1*m;
+//----------------------------------------------------------------------------------------------
+
+//__Killed Track and Saved CPU Counters_________________________________________________________
+std::atomic<std::size_t> _time_killed_count{};
+std::atomic<std::size_t> _energy_killed_count{};
+std::atomic<std::size_t> _range_killed_count{};
+std::atomic<long> _saved_clock{};
+//----------------------------------------------------------------------------------------------
+
+//__Parse Value with Unit from Tokens___________________________________________________________
+double _parse_with_unit(const std::string& value,
+                        const std::string& unit) {
+  return std::stod(value) * G4UIcommand::ValueOf(unit.c_str());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Cut for Particle________________________________________________________________________
+// a particle starts with no cut, setting one cut leaves the other one open
+Process::Cut& _cut(const G4ParticleDefinition* particle) {
+  return _cuts.emplace(particle, Process::Cut{std::numeric_limits<double>::infinity(), 0.0, false})
+              .first->second;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Join Cut Settings___________________________________________________________________________
+const std::string _join_cuts() {
+  std::string out;
+  for (const auto& entry : _cuts) {
+    out += (out.empty() ? "" : " ") + entry.first->GetParticleName() + ":";
+    if (entry.second.max_time < std::numeric_limits<double>::infinity())
+      out += " time < " + std::to_string(entry.second.max_time / ns) + " ns";
+    if (entry.second.min_energy > 0)
+      out += " ke > " + std::to_string(entry.second.min_energy / MeV) + " MeV";
+    if (entry.second.range_out)
+      out += " range > " + (_range_envelope.empty() ? Construction::Builder::GetDetectorName() : _range_envelope)
+           + " - " + std::to_string(_range_margin / m) + " m";
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Setting to ROOT File__________________________________________________________________
+void _write_setting(TFile* file,
+                    const std::string& name,
+                    const std::string& text) {
+  TNamed entry(name.c_str(), text.c_str());
+  file->cd();
+  entry.Write();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Track Cut Process Constructor_______________________________________________________________
+Process::Process()
+    : G4VDiscreteProcess("trackCuts", fGeneral),
+      _cut(nullptr),
+      _kill_reason(None),
+      _envelope_version(0UL),
+      _geometry_version(0UL),
+      _envelope_loaded(false),
+      _lightest_couple(nullptr),
+      _flagged(false),
+      _flag_clock(0),
+      _event_id(-1) {}
+//----------------------------------------------------------------------------------------------
+
+//__Find Cut for New Track______________________________________________________________________
+void Process::StartTracking(G4Track* track) {
+  G4VDiscreteProcess::StartTracking(track);
+  const auto search = _cuts.find(track->GetParticleDefinition());
+  _cut = search == _cuts.cend() ? nullptr : &search->second;
+  _flagged = false;
+  if (!_validate)
+    return;
+
+  // in validation, secondaries created after their parent passed its cut would not exist
+  const auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const auto event_id = event ? event->GetEventID() : -1;
+  if (event_id != _event_id) {
+    _flagged_tracks.clear();
+    _event_id = event_id;
+  }
+  const auto parent = _flagged_tracks.find(track->GetParentID());
+  if (parent != _flagged_tracks.cend() && track->GetGlobalTime() >= parent->second)
+    _flag(*track);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add CPU Time of Flagged Track_______________________________________________________________
+void Process::EndTracking() {
+  if (_flagged)
+    _saved_clock += static_cast<long>(std::clock() - _flag_clock);
+  _flagged = false;
+  G4VDiscreteProcess::EndTracking();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Limit Step to Zero Length at Cut____________________________________________________________
+G4double Process::PostStepGetPhysicalInteractionLength(const G4Track& track,
+                                                       G4double,
+                                                       G4ForceCondition* condition) {
+  *condition = NotForced;
+  if (!_cut || _flagged)
+    return DBL_MAX;
+
+  _kill_reason = _reason(track);
+  if (_kill_reason == None)
+    return DBL_MAX;
+
+  if (!_validate)
+    return 0.0;
+
+  ++(_kill_reason == Time ? _time_killed_count
+   : _kill_reason == Energy ? _energy_killed_count : _range_killed_count);
+  _flag(track);
+  return DBL_MAX;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Kill Track at Cut___________________________________________________________________________
+G4VParticleChange* Process::PostStepDoIt(const G4Track& track,
+                                         const G4Step&) {
+  ++(_kill_reason == Time ? _time_killed_count
+   : _kill_reason == Energy ? _energy_killed_count : _range_killed_count);
+  pParticleChange->Initialize(track);
+  pParticleChange->ProposeTrackStatus(fStopAndKill);
+  // a ranged-out track would have stopped nearby, so its energy stays where it is
+  if (_kill_reason == Range)
+    pParticleChange->ProposeLocalEnergyDeposit(track.GetKineticEnergy());
+  return pParticleChange;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reason to Kill Track________________________________________________________________________
+Process::Reason Process::_reason(const G4Track& track) {
+  if (track.GetGlobalTime() > _cut->max_time)
+    return Time;
+  if (track.GetKineticEnergy() < _cut->min_energy)
+    return Energy;
+  if (_cut->range_out && _out_of_range(track))
+    return Range;
+  return None;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Remaining Range Cannot Reach Envelope______________________________________________
+// the distance to the envelope bounding box is a lower bound on the path to any sensitive
+// volume inside it, and the path may run through any material on the way (mostly cavern air),
+// so the range is taken in the least dense material of the geometry, which bounds the range
+// in any mix of materials along the path
+bool Process::_out_of_range(const G4Track& track) {
+  if (!_load_envelope())
+    return false;
+  const auto& position = track.GetPosition();
+  const G4ThreeVector outside(
+    std::max({_envelope_min.x() - position.x(), 0.0, position.x() - _envelope_max.x()}),
+    std::max({_envelope_min.y() - position.y(), 0.0, position.y() - _envelope_max.y()}),
+    std::max({_envelope_min.z() - position.z(), 0.0, position.z() - _envelope_max.z()}));
+  const auto distance = outside.mag();
+  if (distance <= _range_margin)
+    return false;
+  const auto range = G4LossTableManager::Instance()->GetRange(
+    track.GetParticleDefinition(), track.GetKineticEnergy(), _lightest_couple);
+  return range + _range_margin < distance;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load Range-Out Envelope Bounding Box________________________________________________________
+bool Process::_load_envelope() {
+  const std::size_t version = _range_envelope_version;
+  const auto geometry = Construction::Builder::GetGeometryVersion();
+  if (_envelope_version != version || _geometry_version != geometry) {
+    _envelope_version = version;
+    _geometry_version = geometry;
+    _lightest_couple = nullptr;
+    const auto couples = G4ProductionCutsTable::GetProductionCutsTable();
+    for (std::size_t i{}; i < couples->GetTableSize(); ++i) {
+      const auto couple = couples->GetMaterialCutsCouple(i);
+      if (couple->IsUsed() && (!_lightest_couple
+          || couple->GetMaterial()->GetDensity() < _lightest_couple->GetMaterial()->GetDensity()))
+        _lightest_couple = couple;
+    }
+    const auto& name = _range_envelope.empty() ? Construction::Builder::GetDetectorName() : _range_envelope;
+    _envelope_loaded = _lightest_couple && Construction::GlobalExtent(name, _envelope_min, _envelope_max);
+    if (!_envelope_loaded)
+      std::cout << "[TrackCuts] Envelope \"" << name << "\" Not Found. Range Cut Disabled.\n";
+  }
+  return _envelope_loaded;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Mark Track as Past its Cut__________________________________________________________________
+void Process::_flag(const G4Track& track) {
+  _flagged = true;
+  _flag_clock = std::clock();
+  _flagged_tracks[track.GetTrackID()] = track.GetGlobalTime();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Track Cut Physics Constructor_______________________________________________________________
+Physics::Physics() : G4VPhysicsConstructor("trackCuts") {}
+//----------------------------------------------------------------------------------------------
+
+//__Add Process to All Particles________________________________________________________________
+void Physics::ConstructProcess() {
+  auto process = new Process;
+  auto particles = GetParticleIterator();
+  particles->reset();
+  while ((*particles)()) {
+    const auto particle = particles->value();
+    if (!particle->IsShortLived() && particle->GetProcessManager())
+      particle->GetProcessManager()->AddDiscreteProcess(process);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Track Cut Messenger Directory Path__________________________________________________________
+const std::string Messenger::MessengerDirectory = "/physics/";
+//----------------------------------------------------------------------------------------------
+
+//__Track Cut Messenger Constructor_____________________________________________________________
+Messenger::Messenger() : G4UImessenger(MessengerDirectory, "Global Time, Energy and Range-Out Track Cuts.") {
+  _time_cut = CreateCommand<Command::StringArg>("timeCut",
+    "Kill Particle after Global Time: <particle> <time> <unit>.");
+  _time_cut->SetParameterName("cut", false);
+  _time_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _time_cut->SetToBeBroadcasted(false);
+
+  _emin_cut = CreateCommand<Command::StringArg>("eminCut",
+    "Kill Particle below Kinetic Energy: <particle> <energy> <unit>.");
+  _emin_cut->SetParameterName("cut", false);
+  _emin_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _emin_cut->SetToBeBroadcasted(false);
+
+  _neutron_emin = CreateCommand<Command::DoubleUnitArg>("neutronEmin",
+    "Kill Neutrons below Kinetic Energy.");
+  _neutron_emin->SetParameterName("emin", false, false);
+  _neutron_emin->SetRange("emin >= 0");
+  _neutron_emin->SetDefaultUnit("MeV");
+  _neutron_emin->SetUnitCandidates("eV keV MeV");
+  _neutron_emin->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _neutron_emin->SetToBeBroadcasted(false);
+
+  _range_cut = CreateCommand<Command::StringArg>("rangeCut",
+    "Kill Charged Particles whose Range cannot Reach the Envelope: <particles>.");
+  _range_cut->SetParameterName("particles", false);
+  _range_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _range_cut->SetToBeBroadcasted(false);
+
+  _range_margin = CreateCommand<Command::DoubleUnitArg>("rangeMargin",
+    "Set Safety Margin added to the Range for the Range Cut.");
+  _range_margin->SetParameterName("margin", false, false);
+  _range_margin->SetRange("margin >= 0");
+  _range_margin->SetDefaultUnit("m");
+  _range_margin->SetUnitCandidates("mm cm m");
+  _range_margin->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _range_margin->SetToBeBroadcasted(false);
+
+  _range_envelope = CreateCommand<Command::StringArg>("rangeEnvelope",
+    "Volume Used as Detector Envelope for the Range Cut (Trailing * Matches Prefix).");
+  _range_envelope->SetParameterName("volume", false);
+  _range_envelope->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _range_envelope->SetToBeBroadcasted(false);
+
+  _clear = CreateCommand<Command::NoArg>("clearCuts", "Remove All Track Cuts.");
+  _clear->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _clear->SetToBeBroadcasted(false);
+
+  _validate = CreateCommand<Command::BoolArg>("validateCuts",
+    "Track Past the Cuts and Measure the CPU Time they would Save.");
+  _validate->SetParameterName("validate", false);
+  _validate->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _validate->SetToBeBroadcasted(false);
+
+  _print = CreateCommand<Command::NoArg>("printCuts", "Print Track Cuts.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _print->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Track Cut Messenger Set New Value___________________________________________________________
+void Messenger::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _time_cut || command == _emin_cut) {
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ");
+    tokens.erase(std::remove(tokens.begin(), tokens.end(), ""), tokens.end());
+    if (tokens.size() != 3UL) {
+      std::cout << "[TrackCuts] Expected: <particle> <value> <unit>\n";
+      return;
+    }
+    const auto particle = G4ParticleTable::GetParticleTable()->FindParticle(tokens[0]);
+    if (!particle) {
+      std::cout << "[TrackCuts] Unknown Particle \"" << tokens[0] << "\".\n";
+      return;
+    }
+    try {
+      const auto cut = _parse_with_unit(tokens[1], tokens[2]);
+      if (command == _time_cut)
+        _cut(particle).max_time = cut;
+      else
+        _cut(particle).min_energy = cut;
+    } catch (...) {
+      std::cout << "[TrackCuts] Invalid Cut \"" << value << "\".\n";
+    }
+  } else if (command == _neutron_emin) {
+    const auto neutron = G4ParticleTable::GetParticleTable()->FindParticle("neutron");
+    if (!neutron) {
+      std::cout << "[TrackCuts] Neutron is not Defined before Initialization.\n";
+      return;
+    }
+    _cut(neutron).min_energy = _neutron_emin->GetNewDoubleValue(value);
+  } else if (command == _range_cut) {
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ,");
+    tokens.erase(std::remove(tokens.begin(), tokens.end(), ""), tokens.end());
+    for (const auto& name : tokens) {
+      const auto particle = G4ParticleTable::GetParticleTable()->FindParticle(name);
+      if (!particle || particle->GetPDGCharge() == 0) {
+        std::cout << "[TrackCuts] Range Cut needs a Charged Particle, not \"" << name << "\".\n";
+        continue;
+      }
+      _cut(particle).range_out = true;
+    }
+  } else if (command == _range_margin) {
+    TrackCuts::_range_margin = _range_margin->GetNewDoubleValue(value);
+  } else if (command == _range_envelope) {
+    TrackCuts::_range_envelope = value;
+    ++_range_envelope_version;
+  } else if (command == _clear) {
+    _cuts.clear();
+  } else if (command == _validate) {
+    TrackCuts::_validate = _validate->GetNewBoolValue(value);
+  } else if (command == _print) {
+    std::cout << "Track Cuts: " << (TrackCuts::_validate ? "validate" : "kill")
+              << " | range envelope: "
+              << (TrackCuts::_range_envelope.empty() ? Construction::Builder::GetDetectorName()
+                                                     : TrackCuts::_range_envelope) << "\n";
+    for (const auto& entry : _cuts) {
+      std::cout << "  " << entry.first->GetParticleName();
+      if (entry.second.max_time < std::numeric_limits<double>::infinity())
+        std::cout << " | max time: " << G4BestUnit(entry.second.max_time, "Time");
+      if (entry.second.min_energy > 0)
+        std::cout << " | min ke: " << G4BestUnit(entry.second.min_energy, "Energy");
+      if (entry.second.range_out)
+        std::cout << " | range out with margin: " << G4BestUnit(TrackCuts::_range_margin, "Length");
+      std::cout << "\n";
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable Track Cuts___________________________________________________________________________
+void Enable() {
+  if (_enabled)
+    return;
+  _messenger = new Messenger;
+  _enabled = true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Track Cuts are Enabled_____________________________________________________________
+bool IsEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Track Cuts are Validated___________________________________________________________
+bool Validating() {
+  return _enabled && _validate;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Number of Tracks Killed by Time Cut_________________________________________________________
+std::size_t TimeKilledCount() {
+  return _time_killed_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Number of Tracks Killed by Energy Cut_______________________________________________________
+std::size_t EnergyKilledCount() {
+  return _energy_killed_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Number of Tracks Killed by Range Cut________________________________________________________
+std::size_t RangeKilledCount() {
+  return _range_killed_count;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Track Cut Counters____________________________________________________________________
+void ResetCounters() {
+  _time_killed_count = 0UL;
+  _energy_killed_count = 0UL;
+  _range_killed_count = 0UL;
+  _saved_clock = 0L;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Track Cut Settings and CPU Summary____________________________________________________
+void Save(TFile* file,
+          double cpu_time) {
+  if (!_enabled || !file || _cuts.empty())
+    return;
+
+  _write_setting(file, "TRACK_CUTS", _join_cuts());
+  _write_setting(file, "TRACK_CUT_TIME_KILLED", std::to_string(_time_killed_count));
+  _write_setting(file, "TRACK_CUT_ENERGY_KILLED", std::to_string(_energy_killed_count));
+  _write_setting(file, "TRACK_CUT_RANGE_KILLED", std::to_string(_range_killed_count));
+  std::cout << "\nTrack Cuts: " << _time_killed_count << " killed by time, "
+            << _energy_killed_count << " killed by energy, "
+            << _range_killed_count << " killed by range";
+
+  // the CPU time past the cuts is only known when the cut tracks are followed
+  if (_validate) {
+    const auto saved = static_cast<double>(_saved_clock) / CLOCKS_PER_SEC;
+    const auto fraction = cpu_time > 0 ? saved / cpu_time : 0.0;
+    _write_setting(file, "TRACK_CUT_CPU_SAVED", std::to_string(saved));
+    _write_setting(file, "TRACK_CUT_CPU_FRACTION", std::to_string(fraction));
+    std::cout << " (validation: " << saved << " s of " << cpu_time << " s CPU, "
+              << 100.0 * fraction << "% saved with cuts)";
+  }
+  std::cout << "\n";
+  ResetCounters();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace TrackCuts */ ////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
@@ -0,0 +1,227 @@
+/*
+ * src/scoring.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scoring.hh"
+
+#include <algorithm>
+
+#include <G4ScoringManager.hh>
+#include <G4ScoringBox.hh>
+#include <G4PSEnergyDeposit3D.hh>
+#include <G4PSDoseDeposit3D.hh>
+#include <G4PSCellFlux3D.hh>
+#include <G4SDParticleFilter.hh>
+#include <tls.hh>
+
+#include <TFile.h>
+#include <TH3D.h>
+
+#include "geometry/Construction.hh"
+#include "physics/Units.hh"
+#include "util/string.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Scoring { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Scoring State_______________________________________________________________________________
+bool _enabled = false;
+Messenger* _messenger = nullptr;
+std::vector<std::string> _particle_filters;
+//----------------------------------------------------------------------------------------------
+
+//__Register Scorer with Optional Particle Filter_______________________________________________
+void _add_scorer(G4VScoringMesh* mesh,
+                 G4VPrimitiveScorer* scorer,
+                 const std::string& particle="") {
+  mesh->SetPrimitiveScorer(scorer);
+  if (!particle.empty()) {
+    auto filter = new G4SDParticleFilter(scorer->GetName() + "_filter");
+    filter->add(particle);
+    mesh->SetFilter(filter);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Create Box Mesh Around Volume_______________________________________________________________
+void _create_mesh(const std::string& mesh_name,
+                  const std::string& volume_name,
+                  G4int segments[3]) {
+  G4ThreeVector min, max;
+  if (!Construction::GlobalExtent(volume_name, min, max)) {
+    std::cout << "[Scoring] No Volume Matching \"" << volume_name << "\".\n";
+    return;
+  }
+
+  const auto manager = G4ScoringManager::GetScoringManager();
+  if (manager->FindMesh(mesh_name)) {
+    std::cout << "[Scoring] Mesh \"" << mesh_name << "\" Already Exists.\n";
+    return;
+  }
+
+  auto mesh = new G4ScoringBox(mesh_name);
+  manager->RegisterScoringMesh(mesh);
+
+  G4double size[3] = {0.5 * (max.x() - min.x()), 0.5 * (max.y() - min.y()), 0.5 * (max.z() - min.z())};
+  G4double center[3] = {0.5 * (max.x() + min.x()), 0.5 * (max.y() + min.y()), 0.5 * (max.z() + min.z())};
+  mesh->SetSize(size);
+  mesh->SetCenterPosition(center);
+  mesh->SetNumberOfSegments(segments);
+
+  _add_scorer(mesh, new G4PSEnergyDeposit3D("eDep"));
+  _add_scorer(mesh, new G4PSDoseDeposit3D("dose"));
+  _add_scorer(mesh, new G4PSCellFlux3D("cellFlux"));
+  for (const auto& particle : _particle_filters) {
+    _add_scorer(mesh, new G4PSEnergyDeposit3D("eDep_" + particle), particle);
+    _add_scorer(mesh, new G4PSCellFlux3D("cellFlux_" + particle), particle);
+  }
+
+  manager->CloseCurrentMesh();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Unit of Scored Quantity_____________________________________________________________________
+double _quantity_unit(const std::string& quantity) {
+  if (quantity.rfind("eDep", 0) == 0)
+    return Units::Energy;
+  if (quantity.rfind("dose", 0) == 0)
+    return gray;
+  return 1.0 / (Units::Length * Units::Length);
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Scoring Messenger Directory Path____________________________________________________________
+const std::string Messenger::MessengerDirectory = "/det/score/";
+//----------------------------------------------------------------------------------------------
+
+//__Scoring Messenger Constructor_______________________________________________________________
+Messenger::Messenger() : G4UImessenger(MessengerDirectory, "Scoring Meshes on Passive Material.") {
+  _particles = CreateCommand<Command::StringArg>("particles",
+    "Set Particle Filters for Subsequent Meshes (none to clear).");
+  _particles->SetParameterName("particles", false);
+  _particles->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _particles->SetToBeBroadcasted(false);
+
+  _volume = CreateCommand<Command::StringArg>("volume",
+    "Create Mesh Around Volume: <mesh> <volume[*]> <nx> <ny> <nz>.");
+  _volume->SetParameterName("mesh", false);
+  _volume->AvailableForStates(G4State_Idle);
+  _volume->SetToBeBroadcasted(false);
+
+  _list = CreateCommand<Command::NoArg>("list", "List Scoring Meshes.");
+  _list->AvailableForStates(G4State_PreInit, G4State_Idle);
+  _list->SetToBeBroadcasted(false);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Scoring Messenger Set New Value_____________________________________________________________
+void Messenger::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _particles) {
+    _particle_filters.clear();
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ,");
+    for (auto& token : tokens) {
+      util::string::strip(token);
+      if (!token.empty() && token != "none")
+        _particle_filters.push_back(token);
+    }
+  } else if (command == _volume) {
+    std::vector<std::string> tokens;
+    util::string::split(value, tokens, " ");
+    tokens.erase(std::remove(tokens.begin(), tokens.end(), ""), tokens.end());
+    if (tokens.size() != 5UL) {
+      std::cout << "[Scoring] Expected: <mesh> <volume[*]> <nx> <ny> <nz>\n";
+      return;
+    }
+    G4int segments[3];
+    try {
+      for (std::size_t i{}; i < 3UL; ++i)
+        segments[i] = std::max(1, std::stoi(tokens[2UL + i]));
+    } catch (...) {
+      std::cout << "[Scoring] Invalid Segment Count.\n";
+      return;
+    }
+    _create_mesh(tokens[0], tokens[1], segments);
+  } else if (command == _list) {
+    G4ScoringManager::GetScoringManager()->List();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Enable Scoring Meshes_______________________________________________________________________
+void Enable() {
+  if (_enabled)
+    return;
+  G4ScoringManager::GetScoringManager();
+  _messenger = new Messenger;
+  _enabled = true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Scoring is Enabled_________________________________________________________________
+bool IsEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Merged Meshes as Histograms and Reset_________________________________________________
+void Save(TFile* file) {
+  if (!_enabled || !file)
+    return;
+
+  const auto manager = G4ScoringManager::GetScoringManager();
+  for (std::size_t i{}; i < manager->GetNumberOfMesh(); ++i) {
+    const auto mesh = manager->GetMesh(i);
+    G4int segments[3];
+    mesh->GetNumberOfSegments(segments);
+    const auto center = mesh->GetTranslation() / Units::Length;
+    const auto size = mesh->GetSize() / Units::Length;
+
+    for (const auto& entry : mesh->GetScoreMap()) {
+      const auto& quantity = entry.first;
+      const auto unit = _quantity_unit(quantity);
+      const auto name = mesh->GetWorldName() + "_" + quantity;
+
+      file->cd();
+      TH3D histogram(name.c_str(), name.c_str(),
+        segments[0], center.x() - size.x(), center.x() + size.x(),
+        segments[1], center.y() - size.y(), center.y() + size.y(),
+        segments[2], center.z() - size.z(), center.z() + size.z());
+
+      for (const auto& score : *entry.second->GetMap()) {
+        const auto index = score.first;
+        const auto x = index / (segments[1] * segments[2]);
+        const auto y = (index / segments[2]) % segments[1];
+        const auto z = index % segments[2];
+        histogram.SetBinContent(1 + x, 1 + y, 1 + z, score.second->sum_wx() / unit);
+      }
+      histogram.SetEntries(entry.second->GetMap()->size());
+      histogram.Write();
+    }
+    mesh->ResetScore();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Scoring */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include <G4MTRunManager.hh>
 #include <FTFP_BERT.hh>
 #include <G4StepLimiterPhysics.hh>
@@ -6,18 +8,30 @@
 #include <G4VisExecutive.hh>
 #include <tls.hh>
 
+#include <TROOT.h>
+
 #include "action.hh"
 #include "geometry/Construction.hh"
 #include "geometry/Earth.hh"
 #include "physics/Units.hh"
 #include "ui.hh"
 #include "PhysicsList.hh"
+#include "MuonFastPhysicsList.hh"
 #include "MuonDataController.hh"
+#include "scoring.hh"
+#include "physics/MuonTransport.hh"
+#include "physics/Biasing.hh"
+#include "physics/TrackCuts.hh"
+#include "physics/PhysicsCache.hh"
+#include "physics/EMShower.hh"
+#include "physics/Acceptance.hh"
 
 #include "G4GenericBiasingPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
 
 #include "util/command_line_parser.hh"
 #include "util/error.hh"
+#include "util/string.hh"
 
 //__Main Function: Simulation___________________________________________________________________
 int main(int argc, char* argv[]) {
@@ -36,9 +50,16 @@ int main(int argc, char* argv[]) {
   option events_opt  ('e', "events",   "Event Count",               option::required_arguments);
   option save_all_opt(0,   "save_all", "Save All Generator Events", option::no_arguments);
   option cut_save_opt(0,   "cut_save", "Save Events With Digi Cuts",option::no_arguments);
-  option bias_opt    (0,   "bias",     "Bias Muon Nuclear Interactions in Earth Volume", option::no_arguments);
+  option bias_opt    (0,   "bias",     "Bias Cross-Sections in Earth Volume: Optional Wrapped Particles (default: mu+,mu-)", option::optional_arguments);
   option five_body_muon_decay_opt('f', "five_muon", "Make 3-body muon decay 5-body",     option::no_arguments);
   option non_random_muon_decay_opt('n',"non_random", "Make 5-body muon decays in order", option::no_arguments);
+  option force_decay_opt(0,"force_decay","Force Muon Decays in the Decay Zone", option::no_arguments);
+  option importance_opt(0, "importance", "Geometric Importance Sampling: Optional Particle (default: neutron)", option::optional_arguments);
+  option score_opt   (0,   "score",    "Enable Scoring Meshes",     option::no_arguments);
+  option fast_muon_opt(0,  "fast_muon","Parameterised Muon Transport through Rock", option::no_arguments);
+  option fast_shower_opt(0, "fast_shower", "Parameterised EM Showers in Passive Steel and Concrete", option::no_arguments);
+  option physics_opt (0,   "physics",  "Physics List: ftfp_bert, muon_fast, muon_fast_hadronic", option::required_arguments);
+  option physics_cache_opt(0, "physics-cache", "Physics Table Cache Directory", option::required_arguments);
   option vis_opt     ('v', "vis",      "Visualization",             option::no_arguments);
   option quiet_opt   ('q', "quiet",    "Quiet Mode",                option::no_arguments);
   option thread_opt  ('j', "threads",  "Multi-Threading Mode: Specify Optional number of threads (default: 2)", option::optional_arguments);
@@ -47,7 +68,7 @@ int main(int argc, char* argv[]) {
 
   const auto script_argc = -1 + util::cli::parse(argv,
     {&help_opt, &gen_opt, &det_opt, &shift_opt, &data_opt, &export_opt, &script_opt, &events_opt,
-     &save_all_opt, &cut_save_opt, &bias_opt, &five_body_muon_decay_opt, &non_random_muon_decay_opt, &vis_opt, &quiet_opt, &thread_opt});
+     &save_all_opt, &cut_save_opt, &bias_opt, &five_body_muon_decay_opt, &non_random_muon_decay_opt, &force_decay_opt, &importance_opt, &score_opt, &fast_muon_opt, &fast_shower_opt, &physics_opt, &physics_cache_opt, &vis_opt, &quiet_opt, &thread_opt});
 
 
   util::error::exit_when(script_argc && !script_opt.argument,
@@ -84,6 +105,9 @@ int main(int argc, char* argv[]) {
   } else if (!thread_opt.count) {
     thread_opt.count = 2;
   }
+  // workers open their own ROOT files for the generators
+  ROOT::EnableThreadSafety();
+
   auto run = new G4MTRunManager;
   thread_opt.count=1;
   std::cout << "Warning!!!!! You can only run one thread.  This doesn't work, otherwise." << std::endl;
@@ -94,6 +118,9 @@ int main(int argc, char* argv[]) {
   run->SetPrintProgress(1000);
   run->SetRandomNumberStore(false);
 
+  if (score_opt.count)
+    Scoring::Enable();
+
   Units::Define();
 
   if (shift_opt.argument)
@@ -107,22 +134,90 @@ int main(int argc, char* argv[]) {
   controller->setOn(fiveBodyMuonDecays);
 
   G4GenericBiasingPhysics* biasingPhysics = new G4GenericBiasingPhysics();
-  biasingPhysics->Bias( "mu+" );
-  biasingPhysics->Bias( "mu-" );
+  if (bias_opt.count) {
+    std::vector<std::string> wrapped;
+    util::string::split(bias_opt.argument ? bias_opt.argument : "mu+,mu-", wrapped, ",");
+    wrapped.erase(std::remove(wrapped.begin(), wrapped.end(), ""), wrapped.end());
+    for (const auto& particle : wrapped)
+      biasingPhysics->Bias(particle);
+    Biasing::Enable(wrapped);
+  }
+  if (force_decay_opt.count) {
+    const auto& wrapped = Biasing::Wrapped();
+    for (const auto& particle : {"mu+", "mu-"})
+      if (std::find(wrapped.cbegin(), wrapped.cend(), particle) == wrapped.cend())
+        biasingPhysics->PhysicsBias(particle, {"Decay"});
+    Biasing::EnableForcedDecay();
+  }
+  const auto biasing = bias_opt.count || force_decay_opt.count;
+
+  const auto physics_list = std::string(physics_opt.argument ? physics_opt.argument : "ftfp_bert");
+  util::error::exit_when(physics_list != "ftfp_bert" && physics_list != "muon_fast" && physics_list != "muon_fast_hadronic",
+    "[FATAL ERROR] Unknown Physics List \"", physics_list, "\":\n",
+    "              Choose one of ftfp_bert, muon_fast, or muon_fast_hadronic.\n");
+  util::error::exit_when(fiveBodyMuonDecays && physics_list != "ftfp_bert",
+    "[FATAL ERROR] Incompatible Arguments:\n",
+    "              Five-body muon decays are only available with the ftfp_bert physics list.\n");
 
+  util::error::exit_when(!randomize && !fiveBodyMuonDecays,
+    "You have set the flag -n so that the order of five-body muon decays are not random, but you have not set -f to turn on five-body muon decays. \n Turn on five-body muon decays and try again, or do not use the flag -n");
+
+  G4VModularPhysicsList* physics = nullptr;
   if(fiveBodyMuonDecays){
-    auto physics = new PhysicsList();
-    run->SetUserInitialization(physics);
-  } else if (bias_opt.count){
-    auto physics = new FTFP_BERT;
+    physics = new PhysicsList();
+    if (biasing)
+      physics->RegisterPhysics(biasingPhysics);
+  } else if (physics_list != "ftfp_bert") {
+    physics = new MuonFastPhysicsList(physics_list == "muon_fast_hadronic");
+    if (biasing)
+      physics->RegisterPhysics(biasingPhysics);
+  } else if (biasing){
+    physics = new FTFP_BERT;
     physics->RegisterPhysics( biasingPhysics );
     physics->RegisterPhysics(new G4StepLimiterPhysics);
-    run->SetUserInitialization(physics);
   } else{
-    auto physics = new FTFP_BERT;
+    physics = new FTFP_BERT;
     physics->RegisterPhysics(new G4StepLimiterPhysics);
-    run->SetUserInitialization(physics);
-    util::error::exit_when(!randomize,"You have set the flag -n so that the order of five-body muon decays are not random, but you have not set -f to turn on five-body muon decays. \n Turn on five-body muon decays and try again, or do not use the flag -n");
+  }
+
+  TrackCuts::Enable();
+  Acceptance::Enable();
+  physics->RegisterPhysics(new TrackCuts::Physics);
+
+  if (importance_opt.count)
+    physics->RegisterPhysics(
+      Biasing::EnableImportanceSampling(importance_opt.argument ? importance_opt.argument : "neutron"));
+
+  if (fast_muon_opt.count || fast_shower_opt.count) {
+    auto fastSimulationPhysics = new G4FastSimulationPhysics;
+    if (fast_muon_opt.count) {
+      MuonTransport::Enable();
+      fastSimulationPhysics->ActivateFastSimulation("mu-");
+      fastSimulationPhysics->ActivateFastSimulation("mu+");
+    }
+    if (fast_shower_opt.count) {
+      EMShower::Enable();
+      for (const auto& particle : {"e-", "e+", "gamma"})
+        fastSimulationPhysics->ActivateFastSimulation(particle);
+    }
+    physics->RegisterPhysics(fastSimulationPhysics);
+  }
+  run->SetUserInitialization(physics);
+
+  if (physics_cache_opt.argument) {
+    // constructor names do not carry their options, so the cache key records them explicitly
+    std::string physics_key = fiveBodyMuonDecays ? "five_body" : physics_list;
+    for (const auto& particle : Biasing::Wrapped())
+      physics_key += " bias:" + particle;
+    if (force_decay_opt.count)
+      physics_key += " force_decay";
+    if (importance_opt.count)
+      physics_key += " importance:" + std::string(importance_opt.argument ? importance_opt.argument : "neutron");
+    if (fast_muon_opt.count)
+      physics_key += " fast_muon";
+    if (fast_shower_opt.count)
+      physics_key += " fast_shower";
+    PhysicsCache::Enable(physics_cache_opt.argument, physics_key);
   }
 
   const auto detector = det_opt.argument ? det_opt.argument : "Box";
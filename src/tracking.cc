@@ -25,10 +25,12 @@ Hit::Hit(const G4ParticleDefinition* particle,
          const std::string& chamber,
          const double deposit,
          const G4LorentzVector position,
-         const G4LorentzVector momentum)
+         const G4LorentzVector momentum,
+         const double weight,
+         const double pre_step_weight)
     : G4VHit(), _particle(particle), _trackID(track), _parentID(parent),
       _chamberID(chamber), _deposit(deposit), _position(position),
-      _momentum(momentum) {}
+      _momentum(momentum), _weight(weight), _pre_step_weight(pre_step_weight) {}
 //----------------------------------------------------------------------------------------------
 
 //__Hit Constructor_____________________________________________________________________________
@@ -49,6 +51,8 @@ Hit::Hit(const G4Step* step,
                                step_point->GetPosition()    / Units::Length);
   _momentum  = G4LorentzVector(step_point->GetTotalEnergy() / Units::Energy,
                                step_point->GetMomentum()    / Units::Momentum);
+  _weight          = track->GetWeight();
+  _pre_step_weight = step->GetPreStepPoint()->GetWeight();
 }
 //----------------------------------------------------------------------------------------------
 
@@ -166,7 +170,7 @@ namespace { ////////////////////////////////////////////////////////////////////
 template<class NameMap>
 const Analysis::ROOT::DataEntryList _convert_to_analysis(const HitCollection* collection,
                                                          NameMap name_map) {
-  constexpr const std::size_t column_count = 14UL;
+  constexpr const std::size_t column_count = 15UL;
 
   Analysis::ROOT::DataEntryList out;
   out.reserve(column_count);
@@ -193,7 +197,8 @@ const Analysis::ROOT::DataEntryList _convert_to_analysis(const HitCollection* co
     out[10].push_back(hit->GetMomentum().px());
     out[11].push_back(hit->GetMomentum().py());
     out[12].push_back(hit->GetMomentum().pz());
-    out[13].push_back(1);
+    out[13].push_back(hit->GetWeight());
+    out[14].push_back(hit->GetPreStepWeight());
   }
 
   return out;
@@ -203,7 +208,7 @@ const Analysis::ROOT::DataEntryList _convert_to_analysis(const HitCollection* co
 //__Convert HitCollection to Cut Analysis Form______________________________________________________
 template<class NameMap>
 const Analysis::ROOT::DataEntryList _convert_to_cut_analysis(const HitCollection* collection, std::vector<std::vector<double>> layer_bounds, NameMap name_map) {
-  constexpr const std::size_t column_count = 14UL;
+  constexpr const std::size_t column_count = 15UL;
 
   Analysis::ROOT::DataEntryList out;
   out.reserve(column_count);
@@ -249,7 +254,8 @@ const Analysis::ROOT::DataEntryList _convert_to_cut_analysis(const HitCollection
         out[10].push_back(hit->GetMomentum().px());
         out[11].push_back(hit->GetMomentum().py());
         out[12].push_back(hit->GetMomentum().pz());
-        out[13].push_back(1);
+        out[13].push_back(hit->GetWeight());
+        out[14].push_back(hit->GetPreStepWeight());
       }
   }
 
@@ -315,7 +321,7 @@ const Analysis::ROOT::DataEntryList ConvertToAnalysis(const G4Event* event) {
       out[8].push_back(momentum.x() / Units::Momentum);
       out[9].push_back(momentum.y() / Units::Momentum);
       out[10].push_back(momentum.z() / Units::Momentum);
-      out[11].push_back(1);
+      out[11].push_back(primary->GetWeight());
 
     }
   }
@@ -336,7 +342,7 @@ const Analysis::ROOT::DataEntryList ConvertToAnalysis(const Physics::GenParticle
     }
   }
 
-    constexpr const std::size_t column_count = 20UL;
+    constexpr const std::size_t column_count = 21UL;
 
     Analysis::ROOT::DataEntryList out;
     out.reserve(column_count);
@@ -371,6 +377,7 @@ const Analysis::ROOT::DataEntryList ConvertToAnalysis(const Physics::GenParticle
       out[17].push_back(particle.mom.pT());
       out[18].push_back(particle.mom.eta());
       out[19].push_back(particle.mom.phi());
+      out[20].push_back(particle.weight);
 
   }
 
@@ -3,4 +3,4 @@
 
 DATA_TO="../muon_map/data_$1/"
 mkdir -p $DATA_TO
-./simulation -j$2 -q -o $DATA_TO -s studies/muon_map/loop.mac energy 100 count 1000
+./simulation -j$2 -q -o $DATA_TO -s studies/muon_map/map.mac count 1000